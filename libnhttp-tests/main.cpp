@@ -19,11 +19,23 @@ int main(int argc, char** argv) {
 	test_paths();
 	test_lambda();
 	test_instrusive();
+	test_small_vector();
 
 	test_async();
 	test_hal();
 	test_protocol();
+	test_request_parser();
 	test_net();
+	test_allocs();
+	test_pipelining();
+	test_request_limits();
+	test_expect_continue();
+	test_chunked_response();
+	test_response_packets();
+	test_adaptive_chunks();
+	test_push_response();
+	test_conditional_files();
+	test_span_responses();
 
 	test_operations();
 }
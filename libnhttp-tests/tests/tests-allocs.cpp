@@ -0,0 +1,234 @@
+#include "tests.hpp"
+#include <nhttp/server/http_listener.hpp>
+#include <nhttp/server/http_context.hpp>
+#include <nhttp/server/xfwk/xfwk.hpp>
+
+#include <new>
+#include <thread>
+#include <cstdlib>
+
+/**
+ * counts heap allocations made by `operator new` of all threads
+ * except the threads that drive requests as client.
+ */
+static std::atomic<bool> g_counting(false);
+static std::atomic<size_t> g_allocs(0);
+static thread_local bool g_excluded = false;
+
+static inline void* count_alloc(void* ptr) {
+	if (!ptr)
+		throw std::bad_alloc();
+
+	if (g_counting.load(std::memory_order_relaxed) && !g_excluded)
+		g_allocs.fetch_add(1, std::memory_order_relaxed);
+
+	return ptr;
+}
+
+static inline void* aligned_alloc_c(size_t size, size_t align) {
+#ifdef _MSC_VER
+	return _aligned_malloc(size ? size : 1, align);
+#else
+	return aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align);
+#endif
+}
+
+static inline void aligned_free_c(void* ptr) {
+#ifdef _MSC_VER
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+void* operator new(size_t size) { return count_alloc(malloc(size ? size : 1)); }
+void* operator new[](size_t size) { return count_alloc(malloc(size ? size : 1)); }
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+
+void* operator new(size_t size, std::align_val_t align) { return count_alloc(aligned_alloc_c(size, size_t(align))); }
+void* operator new[](size_t size, std::align_val_t align) { return count_alloc(aligned_alloc_c(size, size_t(align))); }
+void operator delete(void* ptr, std::align_val_t) noexcept { aligned_free_c(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { aligned_free_c(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { aligned_free_c(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { aligned_free_c(ptr); }
+
+using namespace nhttp;
+using namespace nhttp::server;
+using namespace nhttp::server::xfwk;
+
+/* send a request and receive its response fully. */
+static bool send_and_receive(socket_t& sock, const std::string& request) {
+	std::string response;
+	char buf[4096];
+
+	if (sock.write(request.c_str(), request.size()) != ssize_t(request.size()))
+		return false;
+
+	size_t expects = std::string::npos;
+
+	while (response.size() < expects) {
+		ssize_t read = sock.read(buf, sizeof(buf));
+
+		if (read <= 0)
+			return false;
+
+		response.append(buf, size_t(read));
+
+		if (expects == std::string::npos) {
+			size_t end = response.find("\r\n\r\n");
+
+			if (end == std::string::npos)
+				continue;
+
+			size_t cl = response.find("Content-Length: ");
+			expects = end + 4;
+
+			if (cl != std::string::npos && cl < end)
+				expects += size_t(atoll(response.c_str() + cl + 16));
+		}
+	}
+
+	return true;
+}
+
+/**
+ * run `repeats` requests and measure allocations per request.
+ * @param keep_alive reuse one connection for all requests.
+ */
+static double measure(const std::string& request, size_t repeats, bool keep_alive) {
+	socket_t sock;
+	size_t failures = 0;
+
+	auto connect = [&]() {
+		sock = socket_t::create<ipv4_addr, tcp>();
+		return sock.connect(ipv4::resolve("127.0.0.1", 18080));
+	};
+
+	/* warm up pools and caches before counting. */
+	for (size_t i = 0; i < 2; ++i) {
+		if ((!keep_alive || !sock) && !connect())
+			return -1;
+
+		send_and_receive(sock, request);
+
+		if (!keep_alive)
+			sock.close();
+	}
+
+	g_allocs = 0;
+	g_counting = true;
+
+	for (size_t i = 0; i < repeats; ++i) {
+		if (!keep_alive && !connect()) {
+			++failures;
+			continue;
+		}
+
+		if (!send_and_receive(sock, request))
+			++failures;
+
+		if (!keep_alive)
+			sock.close();
+	}
+
+	/* let the server finish resetting the last one. */
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	g_counting = false;
+
+	if (keep_alive)
+		sock.close();
+
+	if (failures)
+		return -1;
+
+	return double(g_allocs.load()) / repeats;
+}
+
+void test_allocs() {
+	test_case label("heap allocations per request.");
+	g_excluded = true;
+
+	socket_watcher watcher(128);
+	http_listener listener(watcher, http_params());
+	std::atomic<int32_t> exit(0);
+
+	if (!listener.with(ipv4::resolve("127.0.0.1", 18080))) {
+		std::cout << " : failed to listen `127.0.0.1:18080`.\n";
+		return;
+	}
+
+	/* 50 KB payload shared by all responses. */
+	auto payload = shared_buffer::make(std::string(50 << 10, 'x'));
+	auto router = std::make_shared<xfwk_router>();
+	listener.extends(router);
+
+	router
+		->get("payload", target_by([&](http_request_ptr) {
+			return make_response(payload, http_mime_type::APPLICATION_JSON);
+		}))
+		->get("ping", target_by([](http_request_ptr) {
+			return make_response("pong");
+		}))
+		->post("echo", target_by([](http_request_ptr req) {
+			std::string body;
+
+			if (!req->get_request_body()->read_all(body))
+				return make_response(400);
+
+			return make_response(body);
+		}));
+
+	std::thread server([&]() {
+		listener.run([&](auto) { return !exit; });
+	});
+
+	struct budget_t {
+		const char* name;
+		std::string request;
+		bool keep_alive;
+		double budget;
+	};
+
+	/* about 15% above the measured counts: lower them with the counts. */
+	const std::string body = "hello=world&libnhttp=yes";
+	const budget_t budgets[] = {
+		{ "GET, new connection",
+		  "GET /ping HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n", false, 57 },
+
+		{ "POST with body, new connection",
+		  "POST /echo HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n"
+		  "Content-Type: application/x-www-form-urlencoded\r\n"
+		  "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body, false, 63 },
+
+		{ "GET, keep-alive",
+		  "GET /ping?a=1&b=2 HTTP/1.1\r\nHost: localhost\r\n\r\n", true, 25 },
+
+		{ "GET shared 50 KB payload, keep-alive",
+		  "GET /payload HTTP/1.1\r\nHost: localhost\r\n\r\n", true, 26 },
+	};
+
+	for (const budget_t& each : budgets) {
+		double allocs = measure(each.request, 200, each.keep_alive);
+
+		if (allocs < 0)
+			std::cout << " : failed, " << each.name << ": requests failed.\n";
+
+		else if (allocs > each.budget) {
+			std::cout << " : failed, " << each.name << ": " << allocs
+					  << " allocations per request, budget is " << each.budget << ".\n";
+		}
+
+		else {
+			std::cout << " : " << each.name << ": " << allocs
+					  << " allocations per request. (budget: " << each.budget << ")\n";
+		}
+	}
+
+	++exit;
+	server.join();
+
+	g_excluded = false;
+}
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <nhttp/hal/rwlock_t.hpp>
 #include <nhttp/hal/socket_raw_t.hpp>
 #include <nhttp/hal/spinlock_t.hpp>
+#include <nhttp/hal/spsc_ring_t.hpp>
+#include <nhttp/hal/vmem_raw_t.hpp>
 
 #include <nhttp/asyncs/context.hpp>
 #include <nhttp/asyncs/future.hpp>
@@ -119,6 +121,68 @@ void test_hal() {
 	spinlock_receiver.wait(-1);
 	label.print_now();
 
+	std::cout << " - test 4. reserve and pre-fault virtual memory region.\n";
+	nhttp::hal::vmem_raw_t region;
+
+	if (!region.reserve(4 * 1024 * 1024, true)) {
+		std::cout << " : failed to reserve 4 MB region.\n";
+	}
+
+	else {
+		region.prefault();
+		std::cout << " : reserved " << region.get_size() << " bytes, huge pages: "
+				  << (region.is_huge_pages() ? "yes" : "no") << "\n";
+
+		region.release();
+	}
+
+	label.print_now();
+
+	std::cout << " - test 5. spsc ring handoff between two workers.\n";
+	nhttp::hal::spsc_ring_t ring(1000);
+
+	auto ring_sender = context.future_of([&]() {
+		uint8_t bytes[333];
+
+		for (uint32_t i = 0, n = 0; i < 3000; ++i) {
+			for (uint8_t& each : bytes)
+				each = uint8_t(n++);
+
+			for (size_t sent = 0; sent < sizeof(bytes); ) {
+				if (!ring.wait_writable())
+					break;
+
+				sent += ring.write(bytes + sent, sizeof(bytes) - sent);
+			}
+		}
+
+		ring.close();
+	});
+
+	auto ring_receiver = context.future_of([&]() {
+		uint8_t bytes[256];
+		size_t total = 0, broken = 0;
+
+		while (ring.wait_readable() && (ring.get_size() || !ring.is_closed())) {
+			size_t len = ring.read(bytes, sizeof(bytes));
+
+			for (size_t i = 0; i < len; ++i) {
+				if (bytes[i] != uint8_t(total + i))
+					++broken;
+			}
+
+			total += len;
+		}
+
+		if (total != 333 * 3000 || broken)
+			std::cout << " : failed, received " << total << " bytes, " << broken << " broken.\n";
+
+		else std::cout << " : received " << total << " bytes in order.\n";
+	});
+
+	ring_receiver.wait(-1);
+	label.print_now();
+
 	std::cout << " : socket_raw_t will be tested with `net::socket_t`. ...\n";
 	std::cout << " : and cleaning async context ...\n";
 }
\ No newline at end of file
@@ -5,8 +5,13 @@
 #include <nhttp/protocol/http_method.hpp>
 #include <nhttp/protocol/http_mime_type.hpp>
 #include <nhttp/protocol/http_query_string.hpp>
+#include <nhttp/protocol/http_request_parser.hpp>
 #include <nhttp/protocol/http_resource.hpp>
 #include <nhttp/protocol/http_status.hpp>
+#include <nhttp/server/internals/http_chunked_buffer.hpp>
+
+#include <random>
+#include <chrono>
 
 using namespace nhttp;
 
@@ -23,6 +28,17 @@ void test_protocol() {
 		std::cout << " : failed to parse: " << s << "\n";
 	}
 
+	/* example of RFC 7231, 7.1.1.1. */
+	http_date example(784111777);
+
+	if (example.stringify() != "Sun, 06 Nov 1994 08:49:37 GMT" ||
+		http_date::cached(784111777) != example.stringify() ||
+		http_date::try_parse(now, "Sun, 06 Nov 1994 08:49:37 GMT", 29, false) <= 0 ||
+		now != example)
+	{
+		std::cout << " : failed to format or parse: " << example.stringify() << "\n";
+	}
+
 	http_header header;
 	std::string tmp;
 
@@ -54,6 +70,26 @@ void test_protocol() {
 		std::cout << " : failed to set: " << s << "\n";
 	}
 
+	/* well-known header ids are case-insensitive. */
+	s = "content-length: 10\r\n";
+	headers.vec.clear();
+
+	if (http_header::try_parse(header, s.c_str(), s.size()) <= 0 ||
+		header != http_header::CONTENT_LENGTH || header.get_id() != http_header::CONTENT_LENGTH._id)
+	{
+		std::cout << " : failed to resolve header id: " << s << "\n";
+	}
+
+	headers.vec.push_back(header);
+	headers.set(std::string("X-Custom"), "1");
+	headers.set(std::string("Content-Length"), "20");
+
+	if (headers.vec.size() != 2 || !headers.get(http_header::CONTENT_LENGTH) ||
+		strcmp(headers.get(http_header::CONTENT_LENGTH), "20") || !headers.isset(std::string("x-custom")))
+	{
+		std::cout << " : failed to replace header in place.\n";
+	}
+
 	http_resource res;
 	tmp = "GET /something HTTP/1.1\r\n";
 
@@ -65,6 +101,17 @@ void test_protocol() {
 		std::cout << " : failed to parse: " << tmp << "\n";
 	}
 
+	/* methods are matched case-insensitively, extension methods keep their names. */
+	http_method m1(" get "), m2("PropFind"), m3("PROPFIND"), m4("GE");
+
+	if (m1 != http_method::GET || !m1.is_well_known() || m1.c_len() != 3 ||
+		m2.is_well_known() || m2 != m3 || strcmp(m2.c_str(), "PROPFIND") ||
+		m2 == http_method::GET || m4.is_well_known() || m4 == m1 ||
+		http_method("") != http_method::NONE || !(m1 < m2) == !(m2 < m1))
+	{
+		std::cout << " : failed to parse methods.\n";
+	}
+
 	http_mime_type mime;
 
 	if (http_mime_type::try_parse(mime, "text/html; charset=UTF-8") < 0 ||
@@ -89,6 +136,24 @@ void test_protocol() {
 		std::cout << " : failed to set: e=f, " << qs.stringify() << "\n";
 	}
 
+	/* repeated keys, escaped pairs and a key without value. */
+	http_query_string qs2;
+	http_query_string::try_parse(qs2, "x=1&k%20y=a+b%21&x=2&&flag");
+
+	if (qs2.size() != 4 || qs2.count("x") != 2 ||
+		strcmp(qs2.get("x"), "1") || strcmp(qs2.get("x", 1), "2") || qs2.get("x", 2) ||
+		strcmp(qs2.get("k y"), "a b!") || !qs2.has("flag") || *qs2.get("flag"))
+	{
+		std::cout << " : failed to parse: x=1&k%20y=a+b%21&x=2&&flag\n";
+	}
+
+	http_resource resource;
+	resource.set_path("/a%20b/c+d?q=1");
+
+	if (resource.get_path() != "/a b/c d" || resource.get_query_string() != "q=1") {
+		std::cout << " : failed to set path: /a%20b/c+d?q=1, " << resource.get_path() << "\n";
+	}
+
 	http_status stats = http_status::_200;
 	tmp.clear();
 
@@ -98,4 +163,266 @@ void test_protocol() {
 	{
 		std::cout << " : failed to parse: " << tmp << "\n";
 	}
+
+	/* response heads keep the order of headers as they were set. */
+	http_headers head;
+	head.set(http_header::SERVER, "libnhttp");
+	head.set(http_header::CONTENT_TYPE, "text/plain");
+	head.set(http_header::CONTENT_LENGTH, "10");
+	tmp.clear();
+
+	stats.set(404);
+	stats.stringify(tmp);
+	head.stringify(tmp);
+
+	if (tmp != "HTTP/1.1 404 Not Found\r\nServer: libnhttp\r\n"
+		"Content-Type: text/plain\r\nContent-Length: 10\r\n\r\n")
+	{
+		std::cout << " : failed to stringify response head: " << tmp << "\n";
+	}
+
+	/* typical response head, written into a buffer which keeps its capacity. */
+	head.set(http_header::DATE, http_date::cached(time(nullptr)));
+	head.set(http_header::CONNECTION, "keep-alive");
+	head.set(std::string("Cache-Control"), "public, must-revalidate");
+
+	const size_t rounds = 100000;
+	auto begin = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < rounds; ++i) {
+		tmp.clear();
+		stats.set(i & 1 ? 200 : 404);
+		stats.stringify(tmp);
+		head.stringify(tmp);
+	}
+
+	double spent = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	std::cout << " : response head, " << tmp.size() << " bytes: " << (spent * 1e9 / rounds) << " ns/response.\n";
+}
+
+/* result of parsing a request, to compare them. */
+struct parsed_request {
+	int32_t ret = 0;
+	size_t used = 0;
+	std::string summary;
+};
+
+/* parse `src` in pieces that split at given cut points. */
+static parsed_request parse_in_pieces(const std::string& src, const std::vector<size_t>& cuts) {
+	http_request_parser parser(4096);
+	http_resource target;
+	http_headers headers;
+	parsed_request out;
+	size_t offset = 0;
+
+	parser.begin(target, headers);
+
+	for (size_t i = 0; i <= cuts.size() && out.ret == http_request_parser::PARSE_AGAIN; ++i) {
+		size_t until = i < cuts.size() ? cuts[i] : src.size(), used = 0;
+
+		if (until < offset)
+			continue;
+
+		out.ret = parser.parse(src.c_str() + offset, until - offset, used);
+		out.used += used;
+		offset = until;
+	}
+
+	if (out.ret == http_request_parser::PARSE_DONE) {
+		out.summary = std::string(target.get_method().c_str()) + " " + target.get_path() + "?" +
+			target.get_query_string() + " " + std::to_string(target.get_minor_ver()) + "\n";
+
+		for (const http_header& each : headers.vec)
+			out.summary += each.get_name() + ": " + each.get_value() + "\n";
+
+		out.summary += std::to_string(parser.framing.content_length) + "/" +
+			std::to_string(parser.framing.host) + "/" + std::to_string(int(parser.framing.chunked)) +
+			std::to_string(int(parser.framing.bad_coding)) + std::to_string(int(parser.framing.keep_alive));
+	}
+
+	else if (out.ret == http_request_parser::PARSE_ERROR)
+		out.summary = std::to_string(parser.get_status());
+
+	return out;
+}
+
+void test_request_parser() {
+	test_case label("protocol/http_request_parser.hpp");
+
+	const char* samples[] = {
+		"GET /index.html?a=1&b=2 HTTP/1.1\r\nHost: localhost:8080\r\nAccept: */*\r\n\r\n",
+		"POST /form HTTP/1.1\r\nHost: a\r\nContent-Length: 5\r\nConnection: close\r\n\r\nhello",
+		"PUT /chunk HTTP/1.1\nTransfer-Encoding: gzip, chunked\nX-Empty:\n\n3\r\nabc\r\n0\r\n\r\n",
+		"\r\nGET / HTTP/1.0\r\nConnection: keep-alive\r\nX-Long:    spaced value   \r\n\r\n",
+		"GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n",
+		"GET / HTTP/1.1\r\nHost: a\r\nHost: b\r\n\r\n",
+		"GET / HTTP/1.1\r\n folded: value\r\n\r\n",
+		"GET /\r\n\r\n",
+		"GET / HTTP/2.0\r\n\r\n",
+		"GET / HTTP/1.1\r\nBroken header\r\n\r\n",
+		"GET / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n",
+	};
+
+	const int32_t expects[] = {
+		http_request_parser::PARSE_DONE, http_request_parser::PARSE_DONE,
+		http_request_parser::PARSE_DONE, http_request_parser::PARSE_DONE,
+		http_request_parser::PARSE_ERROR, http_request_parser::PARSE_ERROR,
+		http_request_parser::PARSE_ERROR, http_request_parser::PARSE_ERROR,
+		http_request_parser::PARSE_ERROR, http_request_parser::PARSE_ERROR,
+		http_request_parser::PARSE_DONE
+	};
+
+	std::mt19937 random(20211017);
+	size_t mismatches = 0;
+
+	std::cout << " - test 1. results don't depend on how bytes are split.\n";
+	for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); ++i) {
+		std::string src = samples[i];
+		parsed_request whole = parse_in_pieces(src, { });
+
+		if (whole.ret != expects[i]) {
+			std::cout << " : failed, sample " << i << " returned " << whole.ret << ".\n";
+			continue;
+		}
+
+		/* body bytes should be left. */
+		if (whole.ret == http_request_parser::PARSE_DONE && src.find("hello") != std::string::npos &&
+			src.substr(whole.used) != "hello")
+		{
+			std::cout << " : failed, sample " << i << " consumed body bytes.\n";
+		}
+
+		for (size_t n = 0; n < 500; ++n) {
+			std::vector<size_t> cuts;
+			size_t pieces = random() % 8 + 1;
+
+			for (size_t k = 0; k < pieces; ++k)
+				cuts.push_back(random() % (src.size() + 1));
+
+			std::sort(cuts.begin(), cuts.end());
+			parsed_request split = parse_in_pieces(src, cuts);
+
+			if (split.ret != whole.ret || split.used != whole.used || split.summary != whole.summary)
+				++mismatches;
+		}
+	}
+
+	std::cout << " - test 2. mutated bytes, split randomly.\n";
+	for (size_t n = 0; n < 5000; ++n) {
+		std::string src = samples[random() % (sizeof(samples) / sizeof(samples[0]))];
+		const char alphabet[] = " :\r\n\tHTP/1.0aZ,";
+
+		for (size_t k = random() % 4; k > 0; --k)
+			src[random() % src.size()] = alphabet[random() % (sizeof(alphabet) - 1)];
+
+		std::vector<size_t> cuts;
+		for (size_t k = random() % 6; k > 0; --k)
+			cuts.push_back(random() % (src.size() + 1));
+
+		std::sort(cuts.begin(), cuts.end());
+
+		parsed_request whole = parse_in_pieces(src, { });
+		parsed_request split = parse_in_pieces(src, cuts);
+
+		if (split.ret != whole.ret || split.used != whole.used || split.summary != whole.summary)
+			++mismatches;
+	}
+
+	if (mismatches)
+		std::cout << " : failed, " << mismatches << " split results differ from whole results.\n";
+
+	label.print_now();
+
+	std::cout << " - test 3. compare with line-by-line parsing of the previous driver.\n";
+	const std::string request =
+		"GET /path/to/resource?query=string HTTP/1.1\r\nHost: localhost:8080\r\n"
+		"User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\nAccept: text/html,application/xhtml+xml\r\n"
+		"Accept-Language: en-US,en;q=0.5\r\nAccept-Encoding: gzip, deflate\r\n"
+		"Connection: keep-alive\r\nCookie: session=0123456789abcdef\r\n\r\n";
+
+	const size_t rounds = 20000;
+
+	/* limits and buffers as the driver configures them by default. */
+	http_request_parser::limits_t limits = { 8192, 8192, 100, 16384, 0 };
+	auto chunk_alloc = std::make_shared<server::http_chunked_alloc>(16, 8192);
+	server::http_chunked_buffer buffer(chunk_alloc);
+	std::vector<char> line_buf;
+
+	/* the whole request at once, and 32 bytes per arrival. */
+	for (size_t segment : { request.size(), size_t(32) }) {
+		auto now = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < rounds; ++i) {
+			http_resource target;
+			http_headers headers;
+			ssize_t found_lf = -1;
+			bool has_target = false, has_done = false;
+
+			/* arrivals are buffered, then each complete line is copied out and parsed. */
+			for (size_t offset = 0; offset < request.size() && !has_done; offset += segment) {
+				const char* live_buf = request.c_str() + offset;
+				size_t read = request.size() - offset < segment ? request.size() - offset : segment;
+
+				if (found_lf < 0) {
+					if (const void* t = memchr(live_buf, '\n', read))
+						found_lf = ssize_t(buffer.get_size() + size_t((const char*)t - live_buf));
+				}
+
+				buffer.write(live_buf, read);
+
+				while (found_lf >= 0 && !has_done) {
+					size_t expected_size = size_t(found_lf) + 1;
+
+					if (line_buf.size() < expected_size)
+						line_buf.resize(expected_size);
+
+					buffer.read(&line_buf[0], expected_size);
+
+					if (!has_target) {
+						found_lf = buffer.find('\n');
+						http_resource::try_parse(target, &line_buf[0], expected_size);
+						has_target = true;
+					}
+
+					else if (found_lf == 0 || (found_lf == 1 && line_buf[0] == '\r'))
+						has_done = true;
+
+					else {
+						http_header header;
+						found_lf = buffer.find('\n');
+
+						http_header::try_parse(header, &line_buf[0], expected_size);
+						headers.vec.push_back(std::move(header));
+					}
+				}
+			}
+
+			/* second pass for framing headers. */
+			headers.find_one(http_header::HOST);
+			headers.find_one(http_header::CONTENT_LENGTH);
+			headers.get(http_header::TRANSFER_ENCODING);
+		}
+
+		double lines = std::chrono::duration<double>(std::chrono::steady_clock::now() - now).count();
+		http_request_parser parser;
+		parser.set_limits(limits);
+		now = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < rounds; ++i) {
+			http_resource target;
+			http_headers headers;
+			size_t used = 0;
+
+			parser.begin(target, headers);
+
+			for (size_t offset = 0; offset < request.size(); offset += segment) {
+				size_t len = request.size() - offset;
+				parser.parse(request.c_str() + offset, len < segment ? len : segment, used);
+			}
+		}
+
+		double single = std::chrono::duration<double>(std::chrono::steady_clock::now() - now).count();
+		std::cout << " : " << segment << " bytes per arrival, line-by-line: " << (lines * 1e9 / rounds)
+				  << " ns/request, single-pass: " << (single * 1e9 / rounds) << " ns/request.\n";
+	}
 }
\ No newline at end of file
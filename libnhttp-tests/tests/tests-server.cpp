@@ -0,0 +1,1215 @@
+#include "tests.hpp"
+#include <nhttp/server/http_listener.hpp>
+#include <nhttp/server/http_context.hpp>
+#include <nhttp/server/xfwk/xfwk.hpp>
+#include <nhttp/server/extensions/http_overlay.hpp>
+
+#include <nhttp/io/file_stream.hpp>
+
+#include <thread>
+#include <chrono>
+
+#if defined(__linux__)
+#include <linux/tcp.h>
+#include <sys/inotify.h>
+#include <pthread.h>
+#endif
+
+using namespace nhttp;
+using namespace nhttp::server;
+using namespace nhttp::server::xfwk;
+
+/**
+ * listener serving on its own thread while a test runs.
+ * each server takes the next port, and stops when it goes out of scope.
+ */
+class test_server {
+private:
+	socket_watcher watcher;
+	http_listener listener;
+	std::shared_ptr<xfwk_router> router;
+	std::atomic<int32_t> exit;
+	std::thread thread;
+	int32_t port;
+	bool listening;
+
+public:
+	test_server(const http_params& params = http_params())
+		: watcher(128), listener(watcher, params), exit(0), port(next_port()), listening(false)
+	{
+		if (!(listening = listener.with(get_addr())))
+			std::cout << " : failed to listen `127.0.0.1:" << port << "`.\n";
+	}
+
+	~test_server() { stop(); }
+
+private:
+	static int32_t next_port() {
+		static std::atomic<int32_t> port(18081);
+		return port++;
+	}
+
+public:
+	inline bool is_listening() const { return listening; }
+	inline http_listener& get_listener() { return listener; }
+	inline ipv4 get_addr() const { return ipv4::resolve("127.0.0.1", port); }
+
+	/* router extended to the listener on the first call. */
+	inline std::shared_ptr<xfwk_router> get_router() {
+		if (!router)
+			listener.extends(router = std::make_shared<xfwk_router>());
+
+		return router;
+	}
+
+	/* run the listener until stopped. */
+	inline void start() {
+		thread = std::thread([this]() {
+			listener.run([this](auto) { return !exit; });
+		});
+	}
+
+	inline void stop() {
+		if (thread.joinable()) {
+			++exit;
+			thread.join();
+		}
+	}
+
+	/* CPU time spent by the event loop in seconds, -1 if unknown. */
+	inline double get_cpu_time() {
+#if defined(__linux__)
+		clockid_t clock;
+		timespec ts;
+
+		if (thread.joinable() && !pthread_getcpuclockid(thread.native_handle(), &clock) &&
+			!clock_gettime(clock, &ts))
+		{
+			return double(ts.tv_sec) + double(ts.tv_nsec) * 1e-9;
+		}
+#endif
+		return -1;
+	}
+};
+
+/* receive `count` responses and collect their bodies in order. */
+static bool receive_bodies(socket_t& sock, size_t count, std::vector<std::string>& bodies) {
+	std::string response;
+	char buf[4096];
+
+	while (bodies.size() < count) {
+		size_t end = response.find("\r\n\r\n");
+
+		if (end != std::string::npos) {
+			size_t cl = response.find("Content-Length: ");
+			size_t length = cl != std::string::npos && cl < end ? size_t(atoll(response.c_str() + cl + 16)) : 0;
+
+			if (response.size() >= end + 4 + length) {
+				bodies.push_back(response.substr(end + 4, length));
+				response.erase(0, end + 4 + length);
+				continue;
+			}
+		}
+
+		ssize_t read = sock.read(buf, sizeof(buf));
+
+		if (read <= 0)
+			return false;
+
+		response.append(buf, size_t(read));
+	}
+
+	return true;
+}
+
+void test_pipelining() {
+	test_case label("http/1.1 pipelining.");
+
+	test_server server;
+	std::atomic<int32_t> running(0), overlaps(0);
+
+	if (!server.is_listening())
+		return;
+
+	server.get_router()
+		->get("slow", target_by([&](http_request_ptr req) {
+			/* another slow request is being handled at the same time. */
+			if (++running > 1)
+				++overlaps;
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(150));
+			--running;
+
+			return make_response(req->get_queries().get("n"));
+		}))
+		->get("quick", target_by([](http_request_ptr req) {
+			return make_response(req->get_queries().get("n"));
+		}))
+		->post("echo", target_by([](http_request_ptr req) {
+			std::string body;
+
+			if (!req->get_request_body()->read_all(body))
+				return make_response(400);
+
+			return make_response(body);
+		}));
+
+	server.start();
+
+	/* later requests finish first if they are handled concurrently. */
+	const std::string requests =
+		"GET /slow?n=0 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+		"GET /slow?n=1 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+		"GET /quick?n=2 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+		"POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 1\r\n\r\n3"
+		"GET /slow?n=4 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+		"GET /quick?n=5 HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+
+	const std::vector<std::string> expects = { "0", "1", "2", "3", "4", "5" };
+	std::vector<std::string> bodies;
+
+	socket_t sock = socket_t::create<ipv4_addr, tcp>();
+	auto now = std::chrono::steady_clock::now();
+
+	if (!sock.connect(server.get_addr()))
+		std::cout << " : failed to connect.\n";
+
+	else if (sock.write(requests.c_str(), requests.size()) != ssize_t(requests.size()))
+		std::cout << " : failed to send requests.\n";
+
+	else if (!receive_bodies(sock, expects.size(), bodies))
+		std::cout << " : failed, received " << bodies.size() << " responses only.\n";
+
+	else if (bodies != expects)
+		std::cout << " : failed, responses are out of order.\n";
+
+	else {
+		char tail;
+
+		/* `Connection: close` ends the pipeline. */
+		if (sock.read(&tail, 1) > 0)
+			std::cout << " : failed, connection is still open after `Connection: close`.\n";
+
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - now).count();
+		std::cout << " : " << expects.size() << " responses in order, " << ms
+				  << " ms. (450 ms or more if handled one by one)\n";
+
+		if (!overlaps || ms >= 450)
+			std::cout << " : failed, pipelined requests were handled one by one.\n";
+	}
+
+	sock.close();
+}
+
+/* send bytes as many as possible, then get the status code of the response. */
+static int32_t request_status(const ipv4& addr, const std::string& request, size_t repeat_tail = 0, size_t* sent = nullptr) {
+	socket_t sock = socket_t::create<ipv4_addr, tcp>();
+	std::string tail = "X-Flood: 0123456789\r\n";
+	int32_t status = 0;
+	size_t total = 0;
+
+	if (!sock.connect(addr))
+		return -1;
+
+	if (sock.write(request.c_str(), request.size()) == ssize_t(request.size())) {
+		std::string flood;
+
+		while (flood.size() < 65536)
+			flood += tail;
+
+		total = request.size();
+
+		/* the server stops reading as soon as a limit is exceeded. */
+		for (size_t i = 0; i < repeat_tail; i += flood.size()) {
+			ssize_t written = sock.write(flood.c_str(), flood.size());
+
+			if (written <= 0)
+				break;
+
+			total += size_t(written);
+		}
+	}
+
+	char buf[32] = { 0, };
+	size_t len = 0;
+
+	while (len < 12) {
+		ssize_t read = sock.read(buf + len, 12 - len);
+
+		if (read <= 0)
+			break;
+
+		len += size_t(read);
+	}
+
+	if (len == 12 && !strncmp(buf, "HTTP/1.1 ", 9))
+		status = atoi(buf + 9);
+
+	if (sent)
+		*sent = total;
+
+	sock.close();
+	return status;
+}
+
+void test_request_limits() {
+	test_case label("request limits.");
+
+	http_params params;
+
+	params.limits.request_line = 256;
+	params.limits.header_count = 16;
+	params.limits.header_size = 256;
+	params.limits.content_length = 1024;
+
+	std::atomic<int32_t> handled(0);
+	test_server server(params);
+
+	if (!server.is_listening())
+		return;
+
+	server.get_router()
+		->get("ok", target_by([&](http_request_ptr req) {
+			++handled;
+			return make_response("ok");
+		}))
+		->post("ok", target_by([&](http_request_ptr req) {
+			++handled;
+			return make_response("ok");
+		}));
+
+	server.start();
+
+	std::string many_headers, long_header = "X-Long: " + std::string(512, 'a') + "\r\n";
+
+	for (int32_t i = 0; i < 20; ++i)
+		many_headers += "X-Header-" + std::to_string(i) + ": 1\r\n";
+
+	struct { const char* name; std::string request; int32_t expects; } cases[] = {
+		{ "within limits", "GET /ok HTTP/1.1\r\nHost: localhost\r\n\r\n", 200 },
+		{ "long request line", "GET /ok?" + std::string(512, 'a') + " HTTP/1.1\r\nHost: localhost\r\n\r\n", 414 },
+		{ "too many headers", "GET /ok HTTP/1.1\r\n" + many_headers + "\r\n", 431 },
+		{ "long header", "GET /ok HTTP/1.1\r\n" + long_header + "\r\n", 431 },
+		{ "large content", "POST /ok HTTP/1.1\r\nHost: localhost\r\nContent-Length: 4096\r\n\r\n", 413 }
+	};
+
+	for (auto& each : cases) {
+		int32_t status = request_status(server.get_addr(), each.request);
+
+		if (status != each.expects) {
+			std::cout << " : failed, " << each.name << ": " << status
+					  << " (expects " << each.expects << ")\n";
+		}
+	}
+
+	if (handled != 1)
+		std::cout << " : failed, " << handled << " requests reached handlers.\n";
+
+	/* header flood: the server work should not grow with the flood. */
+	for (size_t flood : { size_t(1) << 20, size_t(16) << 20 }) {
+		auto now = std::chrono::steady_clock::now();
+		size_t sent = 0;
+		int32_t status = request_status(server.get_addr(), "GET /ok HTTP/1.1\r\n", flood, &sent);
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - now).count();
+
+		if (status != 431)
+			std::cout << " : failed, header flood: " << status << " (expects 431)\n";
+
+		else {
+			std::cout << " : " << (flood >> 20) << " MB header flood: 431 in " << ms
+					  << " ms, " << (sent >> 10) << " KB accepted by the socket.\n";
+		}
+	}
+}
+
+/* read bytes arrived within `ms` milliseconds, or until `stop` is received. */
+static std::string read_for(socket_t& sock, int32_t ms, const char* stop = nullptr) {
+	auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+	std::string bytes;
+	char buf[1024];
+
+	sock.get_raw().set_non_blocking(true);
+
+	while (std::chrono::steady_clock::now() < until) {
+		ssize_t read = sock.read(buf, sizeof(buf));
+
+		if (read > 0) {
+			bytes.append(buf, size_t(read));
+
+			if (stop && bytes.find(stop) != std::string::npos)
+				break;
+
+			continue;
+		}
+
+		/* closed by the server. */
+		if (!read || (sock.get_errno() != EAGAIN && sock.get_errno() != EWOULDBLOCK))
+			break;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	sock.get_raw().set_non_blocking(false);
+	return bytes;
+}
+
+void test_expect_continue() {
+	test_case label("expect: 100-continue.");
+
+	http_params params;
+
+	params.limits.content_length = 1 << 20;
+	test_server server(params);
+
+	if (!server.is_listening())
+		return;
+
+	server.get_router()->post("upload", target_by([](http_request_ptr req) {
+		std::string body;
+
+		/* routing is done before the client sends content. */
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		if (!req->get_request_body()->read_all(body))
+			return make_response(400);
+
+		return make_response(body);
+	}));
+
+	server.start();
+
+	const std::string interim = "HTTP/1.1 100 Continue\r\n\r\n";
+	socket_t sock = socket_t::create<ipv4_addr, tcp>();
+	std::string request =
+		"POST /upload HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n"
+		"Expect: 100-continue\r\n\r\n";
+
+	/* 1. `100 Continue` once the handler reads, then the final response. */
+	if (!sock.connect(server.get_addr()) ||
+		sock.write(request.c_str(), request.size()) != ssize_t(request.size()))
+	{
+		std::cout << " : failed to send a request.\n";
+	}
+
+	else if (read_for(sock, 20).size())
+		std::cout << " : failed, responded before the handler reads content.\n";
+
+	else if (read_for(sock, 1000, "\r\n\r\n") != interim)
+		std::cout << " : failed, no `100 Continue`.\n";
+
+	else if (sock.write("hello", 5) != 5 || read_for(sock, 1000, "hello").find("\r\n\r\nhello") == std::string::npos)
+		std::cout << " : failed, no final response.\n";
+
+	sock.close();
+
+	/* 2, 3. no route and too large: final status without waiting content. */
+	const char* rejects[] = {
+		"POST /nowhere HTTP/1.1\r\nHost: localhost\r\nContent-Length: 65536\r\nExpect: 100-continue\r\n\r\n",
+		"POST /upload HTTP/1.1\r\nHost: localhost\r\nContent-Length: 16777216\r\nExpect: 100-continue\r\n\r\n"
+	};
+
+	for (const char* each : rejects) {
+		auto now = std::chrono::steady_clock::now();
+		std::string response;
+
+		sock = socket_t::create<ipv4_addr, tcp>();
+
+		if (!sock.connect(server.get_addr()) ||
+			sock.write(each, strlen(each)) != ssize_t(strlen(each)))
+		{
+			std::cout << " : failed to send a request.\n";
+		}
+
+		/* the connection is closed after the final response. */
+		else if (!(response = read_for(sock, 2000)).size() || !response.compare(0, interim.size(), interim))
+			std::cout << " : failed, `100 Continue` is sent to a request which isn't read.\n";
+
+		else {
+			double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - now).count();
+			std::cout << " : " << response.substr(0, response.find("\r\n")) << " in " << ms << " ms, no content sent.\n";
+		}
+
+		sock.close();
+	}
+}
+
+/* stream of unknown length, sent with chunked encoding. */
+class pattern_stream : public stream {
+private:
+	size_t left, offset, max_read;
+	bool non_block;
+
+public:
+	pattern_stream(size_t length, bool non_block, size_t max_read = 3001)
+		: left(length), offset(0), max_read(max_read), non_block(non_block) { }
+
+public:
+	virtual bool is_valid() const override { return true; }
+	virtual bool is_end_of() const override { return !left; }
+	virtual bool is_nonblock() const override { return non_block; }
+	virtual bool set_nonblock(bool value) override { return false; }
+	virtual ssize_t get_length() const override { return -1; }
+	virtual ssize_t tell() const override { return -1; }
+	virtual bool seek(ssize_t off, int32_t orig) override { return false; }
+	virtual int32_t write(const void* buf, size_t len) override { return -1; }
+
+	virtual int32_t read(void* buf, size_t len) override {
+		/* odd-sized reads make chunk sizes vary. */
+		len = len > left ? left : len;
+		len = len > max_read ? max_read : len;
+
+		for (size_t i = 0; i < len; ++i)
+			((uint8_t*)buf)[i] = uint8_t((offset + i) % 251);
+
+		offset += len;
+		left -= len;
+
+		set_errno(0);
+		return int32_t(len);
+	}
+};
+
+void test_chunked_response() {
+	test_case label("chunked response with vectored writes.");
+
+	test_server server;
+	const size_t length = 1 << 20;
+
+	if (!server.is_listening())
+		return;
+
+	server.get_router()
+		->get("blocking", target_by([&](http_request_ptr req) {
+			auto res = make_response(200);
+			res->content = std::make_shared<pattern_stream>(length, false);
+			return res;
+		}))
+		->get("nonblock", target_by([&](http_request_ptr req) {
+			auto res = make_response(200);
+			res->content = std::make_shared<pattern_stream>(length, true);
+			return res;
+		}));
+
+	server.start();
+
+	for (const char* path : { "/blocking", "/nonblock" }) {
+		socket_t sock = socket_t::create<ipv4_addr, tcp>();
+		std::string request = std::string("GET ") + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+		std::string response, body;
+		char buf[16384];
+
+		if (!sock.connect(server.get_addr()) ||
+			sock.write(request.c_str(), request.size()) != ssize_t(request.size()))
+		{
+			std::cout << " : failed to send a request.\n";
+			continue;
+		}
+
+		/* read until the server closes. */
+		while (true) {
+			ssize_t read = sock.read(buf, sizeof(buf));
+
+			if (read <= 0)
+				break;
+
+			response.append(buf, size_t(read));
+		}
+
+		sock.close();
+
+		/* decode chunks. */
+		size_t cur = response.find("\r\n\r\n");
+		bool chunked = cur != std::string::npos && response.find("Transfer-Encoding: chunked") < cur;
+
+		for (cur += 4; chunked && cur < response.size(); ) {
+			size_t lf = response.find("\r\n", cur);
+			size_t size = size_t(strtoull(response.c_str() + cur, nullptr, 16));
+
+			if (lf == std::string::npos || !size)
+				break;
+
+			body.append(response, lf + 2, size);
+			cur = lf + 2 + size + 2;
+		}
+
+		bool matches = chunked && body.size() == length &&
+			response.compare(response.size() - 5, 5, "0\r\n\r\n") == 0;
+
+		for (size_t i = 0; matches && i < body.size(); ++i)
+			matches = uint8_t(body[i]) == uint8_t(i % 251);
+
+		if (!matches)
+			std::cout << " : failed, " << path << ": " << body.size() << " bytes decoded.\n";
+	}
+}
+
+/* count of segments with data which the socket received. (-1 if unknown) */
+static int64_t data_segments_in(socket_t& sock) {
+#if defined(__linux__)
+	struct tcp_info info;
+	socklen_t len = sizeof(info);
+
+	memset(&info, 0, sizeof(info));
+	if (!getsockopt(sock.get_raw().get_fd(), IPPROTO_TCP, TCP_INFO, &info, &len) &&
+		len >= offsetof(struct tcp_info, tcpi_data_segs_in) + sizeof(info.tcpi_data_segs_in))
+	{
+		return int64_t(info.tcpi_data_segs_in);
+	}
+#endif
+	return -1;
+}
+
+void test_response_packets() {
+	test_case label("packets per sub-MTU response.");
+
+	test_server server;
+
+	if (!server.is_listening())
+		return;
+
+	const char* path = "packets.bin";
+	std::string file(20000, '\0');
+
+	for (size_t i = 0; i < file.size(); ++i)
+		file[i] = char(i % 251);
+
+	FILE* fp = fopen(path, "wb");
+
+	if (!fp || fwrite(file.c_str(), 1, file.size(), fp) != file.size()) {
+		std::cout << " : failed to write `" << path << "`.\n";
+
+		if (fp)
+			fclose(fp);
+
+		return;
+	}
+
+	fclose(fp);
+
+	server.get_router()
+		->get("file", target_by([&](http_request_ptr req) {
+			auto res = make_response(200);
+			res->content = std::make_shared<file_stream>(path, "rb");
+			return res;
+		}))
+		->get("small", target_by([&](http_request_ptr req) {
+			auto res = make_response(200);
+			res->content = std::make_shared<pattern_stream>(500, true);
+			return res;
+		}))
+		->get("chunks", target_by([&](http_request_ptr req) {
+			auto res = make_response(200);
+			res->content = std::make_shared<pattern_stream>(20000, true);
+			return res;
+		}));
+
+	server.start();
+
+	socket_t sock = socket_t::create<ipv4_addr, tcp>();
+
+	if (!sock.connect(server.get_addr()))
+		std::cout << " : failed to connect.\n";
+
+	/* head and content of each response should arrive as a segment. */
+	for (const char* target : { "/file", "/small", "/chunks" }) {
+		std::string request = std::string("GET ") + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+		std::vector<std::string> bodies;
+		std::string response;
+		int64_t before = data_segments_in(sock);
+
+		if (sock.write(request.c_str(), request.size()) != ssize_t(request.size())) {
+			std::cout << " : failed to send a request.\n";
+			break;
+		}
+
+		if (target[1] == 'f') {
+			if (!receive_bodies(sock, 1, bodies) || bodies[0] != file) {
+				std::cout << " : failed, " << target << ": content differs.\n";
+				break;
+			}
+		}
+
+		else if ((response = read_for(sock, 2000, "\r\n0\r\n\r\n")).find("\r\n0\r\n\r\n") == std::string::npos) {
+			std::cout << " : failed, " << target << ": no chunk terminator.\n";
+			break;
+		}
+
+		if (before < 0) {
+			std::cout << " : segment counts aren't available, skipped.\n";
+			break;
+		}
+
+		int64_t segments = data_segments_in(sock) - before;
+		std::cout << " : " << target << ", " << segments << " segment(s).\n";
+
+		if (segments != 1)
+			std::cout << " : failed, " << target << ": the response is split into " << segments << " segments.\n";
+	}
+
+	sock.close();
+
+	server.stop();
+	remove(path);
+}
+
+/* read a chunked response, slowly if `pace` is set, and collect its chunk sizes. */
+static bool read_chunk_sizes(socket_t& sock, int32_t pace, std::vector<size_t>& sizes, size_t& total) {
+	std::string response;
+	std::vector<char> buf(pace ? 16384 : 262144);
+	size_t cur = std::string::npos;
+
+	total = 0;
+
+	while (true) {
+		ssize_t read = sock.read(&buf[0], buf.size());
+
+		if (read <= 0)
+			return false;
+
+		response.append(&buf[0], size_t(read));
+
+		if (cur == std::string::npos) {
+			if ((cur = response.find("\r\n\r\n")) == std::string::npos)
+				continue;
+
+			cur += 4;
+		}
+
+		/* decode chunks received completely. */
+		while (true) {
+			size_t lf = response.find("\r\n", cur);
+
+			if (lf == std::string::npos)
+				break;
+
+			size_t size = size_t(strtoull(response.c_str() + cur, nullptr, 16));
+
+			if (!size)
+				return true;
+
+			if (response.size() < lf + 2 + size + 2)
+				break;
+
+			for (size_t i = 0; i < size; ++i) {
+				if (uint8_t(response[lf + 2 + i]) != uint8_t((total + i) % 251))
+					return false;
+			}
+
+			sizes.push_back(size);
+			total += size;
+			cur = lf + 2 + size + 2;
+		}
+
+		/* drop decoded bytes. */
+		response.erase(0, cur);
+		cur = 0;
+
+		if (pace)
+			std::this_thread::sleep_for(std::chrono::milliseconds(pace));
+	}
+}
+
+void test_adaptive_chunks() {
+	test_case label("adaptive send chunk size.");
+
+	http_params params;
+
+	params.send_chunk_max_in_kb = 256;
+	test_server server(params);
+
+	if (!server.is_listening())
+		return;
+
+	server.get_router()->get("stream", target_by([&](http_request_ptr req) {
+		auto res = make_response(200);
+		res->content = std::make_shared<pattern_stream>(size_t(atoll(req->get_queries().get("length"))), true, size_t(1) << 30);
+		return res;
+	}));
+
+	server.start();
+
+	const size_t base = params.buffer_size_in_kb * 512, limit = params.send_chunk_max_in_kb << 10;
+
+	/* a client reading as fast as possible, then a client reading 16 KB per 1 ms with small window. */
+	for (int32_t pace : { 0, 1 }) {
+		socket_t sock = socket_t::create<ipv4_addr, tcp>();
+		size_t length = pace ? (size_t(8) << 20) : (size_t(32) << 20);
+		int32_t window = 16384;
+
+		if (pace)
+			setsockopt(sock.get_raw().get_fd(), SOL_SOCKET, SO_RCVBUF, (const char*)&window, sizeof(window));
+
+		std::string request = "GET /stream?length=" + std::to_string(length) +
+			" HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+
+		std::vector<size_t> sizes;
+		size_t total = 0, largest = 0, tail = 0;
+
+		if (!sock.connect(server.get_addr()) ||
+			sock.write(request.c_str(), request.size()) != ssize_t(request.size()))
+		{
+			std::cout << " : failed to send a request.\n";
+			continue;
+		}
+
+		if (!read_chunk_sizes(sock, pace, sizes, total) || total != length) {
+			std::cout << " : failed, " << total << " bytes decoded.\n";
+			sock.close();
+			continue;
+		}
+
+		sock.close();
+
+		/* average of the later half, after the size settled. */
+		for (size_t i = 0; i < sizes.size(); ++i) {
+			largest = sizes[i] > largest ? sizes[i] : largest;
+
+			if (i >= sizes.size() / 2)
+				tail += sizes[i];
+		}
+
+		tail /= sizes.size() - sizes.size() / 2;
+
+		std::cout << " : " << (pace ? "throttled" : "unthrottled") << " client, " << sizes.size() << " chunks, first "
+				  << sizes[0] << ", largest " << largest << ", later average " << tail << " bytes.\n";
+
+		if (sizes[0] != base || largest > limit)
+			std::cout << " : failed, chunk sizes are out of bounds.\n";
+
+		if (!pace && largest <= base)
+			std::cout << " : failed, chunk size didn't grow for a fast client.\n";
+
+		if (pace && tail > limit / 4)
+			std::cout << " : failed, chunk size didn't shrink for a slow client.\n";
+	}
+}
+
+void test_push_response() {
+	test_case label("pushed response with backpressure.");
+
+	const size_t high_water = 16384;
+	std::vector<std::thread> producers;
+	std::atomic<size_t> written(0);
+	std::atomic<int32_t> failures(0), aborts(0);
+	test_server server;
+
+	if (!server.is_listening())
+		return;
+
+	/* pattern bytes pushed by a generator thread, 1000 bytes per write. */
+	server.get_router()->get("push", target_by([&](http_request_ptr req) {
+		auto writer = std::make_shared<push_writer>(high_water);
+		size_t length = size_t(atoll(req->get_queries().get("length")));
+
+		producers.emplace_back([&, writer, length]() {
+			uint8_t piece[1000];
+
+			for (size_t offset = 0; offset < length; offset += sizeof(piece)) {
+				size_t len = length - offset < sizeof(piece) ? length - offset : sizeof(piece);
+
+				for (size_t i = 0; i < len; ++i)
+					piece[i] = uint8_t((offset + i) % 251);
+
+				if (writer->write(piece, len) < 0) {
+					if (writer->get_errno() == EPIPE)
+						++aborts;
+
+					else ++failures;
+					return;
+				}
+
+				written += len;
+
+				if (writer->get_pending() > high_water)
+					++failures;
+			}
+
+			writer->close();
+		});
+
+		return make_response(writer->get_stream());
+	}))
+	->get("idle", target_by([&](http_request_ptr req) {
+		auto writer = std::make_shared<push_writer>(high_water);
+
+		/* a generator with nothing to push for a while. */
+		producers.emplace_back([writer]() {
+			writer->write("hello", 5);
+			std::this_thread::sleep_for(std::chrono::milliseconds(500));
+			writer->write("world", 5);
+			writer->close();
+		});
+
+		return make_response(writer->get_stream());
+	}));
+
+	server.start();
+
+	/* the event loop sleeps while the producer has nothing to push. */
+	{
+		socket_t sock = socket_t::create<ipv4_addr, tcp>();
+		std::string request = "GET /idle HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+
+		if (!sock.connect(server.get_addr()) ||
+			sock.write(request.c_str(), request.size()) != ssize_t(request.size()) ||
+			read_for(sock, 1000, "hello").find("hello") == std::string::npos)
+		{
+			std::cout << " : failed to send a request.\n";
+		}
+
+		else {
+			double cpu = server.get_cpu_time();
+			auto now = std::chrono::steady_clock::now();
+
+			if (read_for(sock, 1000, "0\r\n\r\n").find("world") == std::string::npos)
+				std::cout << " : failed, no bytes after the idle producer.\n";
+
+			else if (cpu >= 0) {
+				double spent = (server.get_cpu_time() - cpu) * 1000;
+				double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - now).count();
+
+				std::cout << " : event loop spent " << spent << " ms of CPU in " << ms << " ms of an idle producer.\n";
+
+				if (spent > ms / 10)
+					std::cout << " : failed, the event loop polled the idle stream.\n";
+			}
+		}
+
+		sock.close();
+	}
+
+	/* a client that pauses after the head, then leaves. */
+	{
+		socket_t sock = socket_t::create<ipv4_addr, tcp>();
+		const size_t length = size_t(32) << 20;
+		std::string request = "GET /push?length=" + std::to_string(length) +
+			" HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+
+		std::string head;
+
+		if (!sock.connect(server.get_addr()) ||
+			sock.write(request.c_str(), request.size()) != ssize_t(request.size()) ||
+			(head = read_for(sock, 1000, "\r\n\r\n")).find("\r\n\r\n") == std::string::npos)
+		{
+			std::cout << " : failed to send a request.\n";
+		}
+
+		else {
+			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			size_t ahead = written;
+
+			if (head.find("Transfer-Encoding: chunked") > head.find("\r\n\r\n"))
+				std::cout << " : failed, the response isn't chunked.\n";
+
+			std::cout << " : producer ran " << (ahead >> 10) << " KB ahead of a paused client, of "
+					  << (length >> 10) << " KB.\n";
+
+			if (ahead >= length)
+				std::cout << " : failed, the producer didn't wait for the client.\n";
+		}
+
+		sock.close();
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	/* a slow client reads all pushed bytes, then one leaves in the middle. */
+	for (bool leave : { false, true }) {
+		socket_t sock = socket_t::create<ipv4_addr, tcp>();
+		size_t length = leave ? (size_t(1) << 30) : (size_t(4) << 20);
+		std::string request = "GET /push?length=" + std::to_string(length) +
+			" HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+
+		std::vector<size_t> sizes;
+		size_t total = 0;
+		char buf[16384];
+
+		if (!sock.connect(server.get_addr()) ||
+			sock.write(request.c_str(), request.size()) != ssize_t(request.size()))
+		{
+			std::cout << " : failed to send a request.\n";
+			continue;
+		}
+
+		if (leave) {
+			for (int32_t i = 0; i < 16 && sock.read(buf, sizeof(buf)) > 0; ++i);
+			sock.close();
+			continue;
+		}
+
+		if (!read_chunk_sizes(sock, 1, sizes, total) || total != length)
+			std::cout << " : failed, " << total << " bytes decoded.\n";
+
+		sock.close();
+	}
+
+	for (auto& each : producers)
+		each.join();
+
+	std::cout << " : " << aborts << " producer(s) stopped by leaving clients.\n";
+
+	if (failures || aborts != 2)
+		std::cout << " : failed, " << failures << " unexpected write result(s).\n";
+}
+
+
+/* count of times the file was opened since the last call. (-1 if unknown) */
+static int32_t opens_of(int32_t watch_fd) {
+	int32_t opens = 0;
+#if defined(__linux__)
+	alignas(struct inotify_event) char buf[4096];
+	ssize_t len;
+
+	if (watch_fd < 0)
+		return -1;
+
+	while ((len = read(watch_fd, buf, sizeof(buf))) > 0) {
+		for (char* cur = buf; cur < buf + len; ) {
+			struct inotify_event* event = (struct inotify_event*)cur;
+
+			if (event->mask & IN_OPEN)
+				++opens;
+
+			cur += sizeof(struct inotify_event) + event->len;
+		}
+	}
+
+	return opens;
+#else
+	return -1;
+#endif
+}
+
+void test_conditional_files() {
+	test_case label("conditional requests without opening files.");
+
+	test_server server;
+
+	if (!server.is_listening())
+		return;
+
+	const char* path = "revalidate.txt";
+	std::string file(10000, 'x');
+	FILE* fp = fopen(path, "wb");
+
+	if (!fp || fwrite(file.c_str(), 1, file.size(), fp) != file.size()) {
+		std::cout << " : failed to write `" << path << "`.\n";
+
+		if (fp)
+			fclose(fp);
+
+		return;
+	}
+
+	fclose(fp);
+
+	int32_t watch_fd = -1;
+#if defined(__linux__)
+	if ((watch_fd = inotify_init1(IN_NONBLOCK)) >= 0 && inotify_add_watch(watch_fd, path, IN_OPEN) < 0) {
+		::close(watch_fd);
+		watch_fd = -1;
+	}
+#endif
+
+	server.get_listener().extends(overlay_of(".", ""));
+	server.start();
+
+	/* send a request on new connection and read until the server closes. */
+	auto exchange = [&](const std::string& request) {
+		socket_t sock = socket_t::create<ipv4_addr, tcp>();
+		std::string response;
+
+		if (sock.connect(server.get_addr()) &&
+			sock.write(request.c_str(), request.size()) == ssize_t(request.size()))
+		{
+			response = read_for(sock, 3000);
+		}
+
+		sock.close();
+		return response;
+	};
+
+	/* value of the header in the response head. */
+	auto header_of = [](const std::string& response, const char* name) {
+		size_t end = response.find("\r\n\r\n");
+		size_t at = response.find(std::string("\r\n") + name + ": ");
+
+		if (at == std::string::npos || at > end)
+			return std::string();
+
+		at += strlen(name) + 4;
+		return response.substr(at, response.find("\r\n", at) - at);
+	};
+
+	const std::string tail = " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n";
+	std::string response = exchange(std::string("GET /") + path + tail + "\r\n");
+	std::string etag = header_of(response, "ETag");
+	int32_t opened = opens_of(watch_fd);
+
+	if (response.compare(0, 12, "HTTP/1.1 200") || !etag.size() || response.size() < file.size())
+		std::cout << " : failed, the file isn't served.\n";
+
+	const struct {
+		const char* name;
+		std::string request;
+		const char* status;
+	} cases[] = {
+		{ "If-None-Match", std::string("GET /") + path + tail + "If-None-Match: " + etag + "\r\n\r\n", "HTTP/1.1 304" },
+		{ "If-Match", std::string("GET /") + path + tail + "If-Match: \"NH-other\"\r\n\r\n", "HTTP/1.1 412" },
+		{ "HEAD", std::string("HEAD /") + path + tail + "\r\n", "HTTP/1.1 200" },
+	};
+
+	const size_t repeats = 50;
+
+	for (const auto& each : cases) {
+		size_t failures = 0;
+
+		for (size_t i = 0; i < repeats; ++i) {
+			response = exchange(each.request);
+
+			if (response.compare(0, 12, each.status))
+				++failures;
+
+			/* HEAD reports the length of the file without sending it. */
+			else if (each.name[0] == 'H' && (header_of(response, "Content-Length") != std::to_string(file.size()) ||
+				response.size() != response.find("\r\n\r\n") + 4))
+			{
+				++failures;
+			}
+		}
+
+		int32_t opens = opens_of(watch_fd);
+
+		std::cout << " : " << each.name << ", " << opens << " open(s) per " << repeats << " requests."
+				  << " (a GET with content opened " << opened << ")\n";
+
+		if (failures || opens > 0)
+			std::cout << " : failed, " << each.name << ": " << failures << " unexpected response(s).\n";
+	}
+
+	server.stop();
+
+	if (watch_fd >= 0)
+		::close(watch_fd);
+
+	remove(path);
+}
+
+/* counts reads to tell whether the bytes were sent from spans. */
+class counting_stream : public shared_buffer_stream {
+private:
+	std::atomic<int32_t>& reads;
+
+public:
+	counting_stream(const std::shared_ptr<const shared_buffer>& buffer, std::atomic<int32_t>& reads)
+		: shared_buffer_stream(buffer), reads(reads) { }
+
+public:
+	virtual int32_t read(void* buf, size_t len) override {
+		++reads;
+		return shared_buffer_stream::read(buf, len);
+	}
+};
+
+void test_span_responses() {
+	test_case label("responses sent from stream spans.");
+
+	/* reserved span of memory stream: the rest isn't kept. */
+	{
+		memory_stream mem;
+		size_t len = 64, peeked = 64;
+		uint8_t* span = mem.reserve_span(len);
+
+		memcpy(span, "hello", 5);
+		mem.commit(5);
+		mem.seek(0, SEEK_SET);
+
+		const uint8_t* bytes = mem.peek_span(peeked);
+
+		if (len != 64 || mem.get_length() != 5 || !bytes || peeked != 5 || memcmp(bytes, "hello", 5))
+			std::cout << " : failed, memory_stream spans.\n";
+	}
+
+	std::atomic<int32_t> reads(0);
+	test_server server;
+
+	if (!server.is_listening())
+		return;
+
+	const size_t length = 1 << 20, offset = 1000, range = 300000;
+	std::string bytes(length, '\0');
+
+	for (size_t i = 0; i < length; ++i)
+		bytes[i] = char(i % 251);
+
+	auto payload = shared_buffer::make(bytes.data(), bytes.size());
+
+	server.get_router()
+		->get("push", target_by([&](http_request_ptr req) {
+			push_writer writer(length);
+
+			writer.write(bytes.data(), bytes.size());
+			return make_response(writer.get_stream());
+		}))
+		->get("range", target_by([&](http_request_ptr req) {
+			return make_response(std::make_shared<counting_stream>(payload, reads), offset, range);
+		}))
+		->get("memory", target_by([&](http_request_ptr req) {
+			return make_response(bytes);
+		}))
+		->get("shared", target_by([&](http_request_ptr req) {
+			return make_response(std::make_shared<counting_stream>(payload, reads));
+		}));
+
+	server.start();
+
+	const struct {
+		const char* path;
+		size_t begin, length;
+	} cases[] = {
+		{ "/shared", 0, length },
+		{ "/range", offset, range },
+		{ "/memory", 0, length },
+		{ "/push", 0, length },
+	};
+
+	for (const auto& each : cases) {
+		socket_t sock = socket_t::create<ipv4_addr, tcp>();
+		std::string request = std::string("GET ") + each.path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+		std::vector<size_t> sizes;
+		size_t total = 0;
+
+		if (!sock.connect(server.get_addr()) ||
+			sock.write(request.c_str(), request.size()) != ssize_t(request.size()))
+		{
+			std::cout << " : failed to send a request.\n";
+			continue;
+		}
+
+		/* pushed bytes are sent with chunked encoding. */
+		if (each.path[1] == 'p') {
+			if (!read_chunk_sizes(sock, 0, sizes, total) || total != each.length)
+				std::cout << " : failed, " << each.path << ": " << total << " bytes decoded.\n";
+
+			sock.close();
+			continue;
+		}
+
+		std::string response = read_for(sock, 5000);
+		size_t body = response.find("\r\n\r\n") + 4;
+		bool matches = body >= 4 && response.size() - body == each.length;
+
+		for (size_t i = 0; matches && i < each.length; ++i)
+			matches = uint8_t(response[body + i]) == uint8_t((each.begin + i) % 251);
+
+		if (!matches)
+			std::cout << " : failed, " << each.path << ": " << (response.size() - body) << " bytes received.\n";
+
+		sock.close();
+	}
+
+	std::cout << " : " << reads << " read(s) on streams having spans.\n";
+
+	if (reads)
+		std::cout << " : failed, bytes were copied out of streams having spans.\n";
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <nhttp/utils/path.hpp>
 #include <nhttp/utils/lambda_t.hpp>
 #include <nhttp/utils/instrusive.hpp>
+#include <nhttp/utils/small_vector.hpp>
 
 /**
  * Test functions for utilities.
@@ -185,4 +186,36 @@ void test_instrusive() {
 	if (!should_be_zero.ready) {
 		std::cout << " : should_be_zero.set(100).ready should be true\n";
 	}
+}
+
+void test_small_vector() {
+	test_case label("utils/small_vector.hpp");
+
+	nhttp::utils::small_vector<std::string, 4> vec;
+
+	for (int i = 0; i < 4; ++i)
+		vec.push_back(std::to_string(i));
+
+	if (vec.capacity() != 4 || vec.size() != 4) {
+		std::cout << " : 4 elements should be stored inline.\n";
+	}
+
+	vec.emplace_back("4");
+	if (vec.capacity() <= 4 || vec.size() != 5 || vec.back() != "4") {
+		std::cout << " : 5th element should move elements to heap.\n";
+	}
+
+	vec.erase(vec.begin() + 1);
+	if (vec.size() != 4 || vec[1] != "2" || vec[3] != "4") {
+		std::cout << " : erase(begin() + 1) should shift elements after it.\n";
+	}
+
+	auto copied = vec;
+	auto moved = std::move(vec);
+
+	if (copied.size() != 4 || moved.size() != 4 || vec.size() != 0 ||
+		copied[0] != "0" || moved[3] != "4")
+	{
+		std::cout << " : copy and move should keep elements.\n";
+	}
 }
\ No newline at end of file
@@ -41,9 +41,21 @@ void test_strings();
 void test_paths();
 void test_lambda();
 void test_instrusive();
+void test_small_vector();
 
 
 void test_async();
 void test_hal();
 void test_net();
-void test_protocol();
\ No newline at end of file
+void test_protocol();
+void test_request_parser();
+void test_allocs();
+void test_pipelining();
+void test_request_limits();
+void test_expect_continue();
+void test_chunked_response();
+void test_response_packets();
+void test_adaptive_chunks();
+void test_push_response();
+void test_conditional_files();
+void test_span_responses();
\ No newline at end of file
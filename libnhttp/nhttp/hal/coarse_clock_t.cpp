@@ -0,0 +1,44 @@
+#include "coarse_clock_t.hpp"
+
+#if NHTTP_OS_WINDOWS
+#include <Windows.h>
+#endif
+#if NHTTP_OS_POSIX
+#	if defined(__linux__)
+#	include <time.h>
+#	else
+#	include <chrono>
+#	endif
+#endif
+
+namespace nhttp {
+namespace hal {
+
+	int64_t coarse_clock_t::monotonic() {
+#if NHTTP_OS_WINDOWS
+		return int64_t(GetTickCount64());
+#elif defined(__linux__)
+		struct timespec ts;
+
+		if (clock_gettime(CLOCK_MONOTONIC_COARSE, &ts))
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+
+		return int64_t(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#else
+		return std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	time_t coarse_clock_t::realtime() {
+#if defined(__linux__)
+		struct timespec ts;
+
+		if (!clock_gettime(CLOCK_REALTIME_COARSE, &ts))
+			return ts.tv_sec;
+#endif
+		return time(nullptr);
+	}
+
+}
+}
\ No newline at end of file
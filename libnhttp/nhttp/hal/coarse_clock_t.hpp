@@ -0,0 +1,24 @@
+#pragma once
+#include "os/winapi.hpp"
+#include "os/posix.hpp"
+#include <ctime>
+
+namespace nhttp {
+namespace hal {
+
+	/**
+	 * class coarse_clock_t.
+	 * cheap clocks with tick resolution for timeouts and timestamps.
+	 * (CLOCK_MONOTONIC_COARSE, CLOCK_REALTIME_COARSE, GetTickCount64)
+	 */
+	class NHTTP_API coarse_clock_t {
+	public:
+		/* milliseconds from an unspecified point, never goes backward. */
+		static int64_t monotonic();
+
+		/* seconds since the epoch. */
+		static time_t realtime();
+	};
+
+}
+}
\ No newline at end of file
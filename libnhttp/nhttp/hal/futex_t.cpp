@@ -0,0 +1,76 @@
+#include "futex_t.hpp"
+
+#if NHTTP_OS_WINDOWS
+#include <Windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#endif
+#if NHTTP_OS_POSIX
+#	if defined(__linux__)
+#	include <linux/futex.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#	include <time.h>
+#	else
+#	include <thread>
+#	include <chrono>
+#	endif
+#endif
+
+namespace nhttp {
+namespace hal {
+
+	bool futex_t::wait(std::atomic<uint32_t>& word, uint32_t expected, int32_t timeout) {
+		static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+			"futex word should be a plain 32-bit integer.");
+
+#if NHTTP_OS_WINDOWS
+		if (!WaitOnAddress(&word, &expected, sizeof(expected), timeout < 0 ? INFINITE : DWORD(timeout)))
+			return GetLastError() != ERROR_TIMEOUT;
+
+		return true;
+#elif defined(__linux__)
+		struct timespec ts, *tsp = nullptr;
+
+		if (timeout >= 0) {
+			ts.tv_sec = timeout / 1000;
+			ts.tv_nsec = (timeout % 1000) * 1000000;
+			tsp = &ts;
+		}
+
+		if (syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAIT_PRIVATE, expected, tsp, nullptr, 0) < 0)
+			return errno != ETIMEDOUT;
+
+		return true;
+#else
+		/* no futex on this platform: poll the word instead. */
+		auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+		while (word.load(std::memory_order_acquire) == expected) {
+			if (timeout >= 0 && std::chrono::steady_clock::now() >= until)
+				return false;
+
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+
+		return true;
+#endif
+	}
+
+	void futex_t::wake_one(std::atomic<uint32_t>& word) {
+#if NHTTP_OS_WINDOWS
+		WakeByAddressSingle(&word);
+#elif defined(__linux__)
+		syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+	}
+
+	void futex_t::wake_all(std::atomic<uint32_t>& word) {
+#if NHTTP_OS_WINDOWS
+		WakeByAddressAll(&word);
+#elif defined(__linux__)
+		syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+	}
+
+}
+}
\ No newline at end of file
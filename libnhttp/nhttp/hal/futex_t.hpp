@@ -0,0 +1,28 @@
+#pragma once
+#include "os/winapi.hpp"
+#include "os/posix.hpp"
+
+namespace nhttp {
+namespace hal {
+
+	/**
+	 * class futex_t.
+	 * wait on and wake an atomic 32-bit word. (futex, WaitOnAddress)
+	 */
+	class NHTTP_API futex_t {
+	public:
+		/**
+		 * sleep while the word equals to `expected`.
+		 * @returns false if timed out.
+		 */
+		static bool wait(std::atomic<uint32_t>& word, uint32_t expected, int32_t timeout = -1);
+
+		/* wake one waiter sleeping on the word. */
+		static void wake_one(std::atomic<uint32_t>& word);
+
+		/* wake all waiters sleeping on the word. */
+		static void wake_all(std::atomic<uint32_t>& word);
+	};
+
+}
+}
\ No newline at end of file
@@ -15,6 +15,12 @@
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/uio.h>
+#include <climits>
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#include <sys/ioctl.h>
+#include <linux/sockios.h>
+#endif
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
@@ -531,10 +537,61 @@ namespace hal {
     }
 
     bool socket_raw_t::set_naggle_enabled(bool on) {
-        int val = on ? 1 : 0;
+        int val = on ? 0 : 1; /* TCP_NODELAY disables the algorithm. */
         return set_option(IPPROTO_TCP, TCP_NODELAY, &val, sizeof(int));
     }
 
+    bool socket_raw_t::set_cork_enabled(bool on) {
+        int val = on ? 1 : 0;
+#if defined(TCP_CORK)
+        return set_option(IPPROTO_TCP, TCP_CORK, &val, sizeof(int));
+#elif defined(TCP_NOPUSH)
+        return set_option(IPPROTO_TCP, TCP_NOPUSH, &val, sizeof(int));
+#else
+        err = ENOTSUP;
+        return false;
+#endif
+    }
+
+    ssize_t socket_raw_t::get_send_space() const {
+        if (fd != INVALID_SOCKET_FD) {
+#if defined(__linux__)
+            int sndbuf = 0, queued = 0;
+            socklen_t len = sizeof(sndbuf);
+
+            if (!get_option(SOL_SOCKET, SO_SNDBUF, &sndbuf, &len))
+                return -1;
+
+            if (::ioctl(fd, SIOCOUTQ, &queued) < 0) {
+                err = get_last_error();
+                return -1;
+            }
+
+            /* the kernel reports doubled size for its bookkeeping. */
+            sndbuf /= 2;
+            return sndbuf > queued ? ssize_t(sndbuf - queued) : 0;
+#elif NHTTP_OS_WINDOWS
+            ULONG backlog = 0;
+            DWORD bytes = 0;
+
+            if (::WSAIoctl(fd, SIO_IDEAL_SEND_BACKLOG_QUERY, nullptr, 0,
+                &backlog, sizeof(backlog), &bytes, nullptr, nullptr))
+            {
+                err = get_last_error();
+                return -1;
+            }
+
+            return ssize_t(backlog);
+#else
+            err = ENOTSUP;
+            return -1;
+#endif
+        }
+
+        err = ENOTSOCK;
+        return -1;
+    }
+
     bool socket_raw_t::set_reuse_address(bool allow) {
         int val = allow ? 1 : 0;
         return set_option(SOL_SOCKET, SO_REUSEADDR, &val, sizeof(val));
@@ -677,6 +734,64 @@ namespace hal {
         return -1;
     }
 
+    ssize_t socket_raw_t::writev(const io_slice_t* slices, size_t count) {
+        if (fd != INVALID_SOCKET_FD) {
+#if NHTTP_OS_WINDOWS
+            WSABUF bufs[16];
+            DWORD written = 0;
+
+            if (count > 16) count = 16;
+            for (size_t i = 0; i < count; ++i) {
+                bufs[i].buf = (CHAR*) slices[i].data;
+                bufs[i].len = ULONG(slices[i].size > 0x7ffffffful ? 0x7ffffffful : slices[i].size);
+            }
+
+            if (::WSASend(fd, bufs, DWORD(count), &written, 0, nullptr, nullptr) == SOCKET_ERROR) {
+                err = get_last_error();
+                return -1;
+            }
+
+            return ssize_t(written);
+#else
+            static_assert(sizeof(io_slice_t) == sizeof(iovec), "io_slice_t should be same with iovec.");
+
+            if (count > IOV_MAX) count = IOV_MAX;
+            ssize_t written = ::writev(fd, (const iovec*) slices, int(count));
+
+            if (written < 0) {
+                err = get_last_error();
+            }
+
+            return written;
+#endif
+        }
+
+        err = ENOTSOCK;
+        return -1;
+    }
+
+    ssize_t socket_raw_t::sendfile(int32_t file_fd, int64_t& offset, size_t count) {
+        if (fd != INVALID_SOCKET_FD) {
+#if defined(__linux__)
+            off_t off = off_t(offset);
+            ssize_t sent = ::sendfile(fd, file_fd, &off, count > 0x7ffff000ul ? 0x7ffff000ul : count);
+
+            if (sent < 0) {
+                err = get_last_error();
+            }
+
+            else offset = int64_t(off);
+            return sent;
+#else
+            err = ENOTSUP;
+            return -1;
+#endif
+        }
+
+        err = ENOTSOCK;
+        return -1;
+    }
+
     /*ssize_t socket_raw_t::write_n(const void* buf, size_t n) {
         if (fd != INVALID_SOCKET_FD) {
             uint8_t* bytes = (uint8_t*)buf;
@@ -726,6 +841,8 @@ namespace hal {
             ::close(fd);
 #endif
 
+            /* the descriptor can be reused by others from now. */
+            fd = INVALID_SOCKET_FD;
             return true;
         }
 
@@ -43,6 +43,12 @@ namespace hal {
 	struct tcp { };
 	struct udp { };
 
+	/* a slice of bytes for vectored I/O. (same layout with `iovec` on POSIX) */
+	struct io_slice_t {
+		const void* data;
+		size_t size;
+	};
+
 	/* resolve ip address. */
 	NHTTP_API bool resolve(ipv4_addr& out, const char* in_string);
 	NHTTP_API bool resolve(ipv6_addr& out, const char* in_string);
@@ -144,6 +150,15 @@ namespace hal {
 	public:
 		bool set_non_blocking(bool on);
 		bool set_naggle_enabled(bool on);
+
+		/* hold partial frames until uncorked. (TCP_CORK, TCP_NOPUSH) */
+		bool set_cork_enabled(bool on);
+
+		/**
+		 * get free bytes of send buffer. (SO_SNDBUF - SIOCOUTQ, ideal send backlog on windows)
+		 * @returns -1 if unknown.
+		 */
+		ssize_t get_send_space() const;
 		bool set_reuse_address(bool allow);
 		bool set_read_timeout(int32_t millisec);
 		bool set_write_timeout(int32_t millisec);
@@ -161,6 +176,16 @@ namespace hal {
 		ssize_t write(const void* buf, size_t n);
 		//ssize_t write_n(const void* buf, size_t n);
 
+		/* write slices with a single system call. */
+		ssize_t writev(const io_slice_t* slices, size_t count);
+
+		/**
+		 * send bytes of a file without copying them into user space.
+		 * @param offset advanced by sent bytes.
+		 * @returns sent bytes, or -1 with ENOTSUP if not supported on this platform.
+		 */
+		ssize_t sendfile(int32_t file_fd, int64_t& offset, size_t count);
+
 	public:
 		bool shutdown(int how = SHUT_RDWR);
 		bool close();
@@ -0,0 +1,187 @@
+#include "spsc_ring_t.hpp"
+#include <string.h>
+
+namespace nhttp {
+namespace hal {
+
+	inline size_t round_up_pow2(size_t value) {
+		size_t n = 64;
+
+		while (n < value)
+			n <<= 1;
+
+		return n;
+	}
+
+	spsc_ring_t::spsc_ring_t(size_t capacity)
+		: capacity(round_up_pow2(capacity)), w_pos(0), r_pos(0),
+		  r_seq(0), w_seq(0), r_wait(0), w_wait(0), closed(false)
+	{
+		mask = this->capacity - 1;
+		data = new uint8_t[this->capacity];
+	}
+
+	spsc_ring_t::~spsc_ring_t() {
+		delete[] data;
+	}
+
+	size_t spsc_ring_t::write(const void* buf, size_t len) {
+		size_t total = 0;
+
+		while (len) {
+			size_t span = len;
+			uint8_t* dest = reserve(span);
+
+			if (!dest)
+				break;
+
+			memcpy(dest, (const uint8_t*)buf + total, span);
+			commit(span);
+
+			total += span;
+			len -= span;
+		}
+
+		return total;
+	}
+
+	uint8_t* spsc_ring_t::reserve(size_t& len) {
+		size_t w = w_pos.load(std::memory_order_relaxed);
+		size_t space = capacity - (w - r_pos.load(std::memory_order_acquire));
+		size_t offset = w & mask;
+
+		if (is_closed() || !space) {
+			len = 0;
+			return nullptr;
+		}
+
+		/* limit to the tail of underlying memory. */
+		if (space > capacity - offset)
+			space = capacity - offset;
+
+		if (len > space)
+			len = space;
+
+		return data + offset;
+	}
+
+	void spsc_ring_t::commit(size_t len) {
+		if (len) {
+			w_pos.store(w_pos.load(std::memory_order_relaxed) + len, std::memory_order_release);
+			wake(r_wait, r_seq);
+		}
+	}
+
+	size_t spsc_ring_t::read(void* buf, size_t len) {
+		size_t total = 0;
+
+		while (len) {
+			size_t span = len;
+			const uint8_t* src = peek(span);
+
+			if (!src)
+				break;
+
+			memcpy((uint8_t*)buf + total, src, span);
+			consume(span);
+
+			total += span;
+			len -= span;
+		}
+
+		return total;
+	}
+
+	const uint8_t* spsc_ring_t::peek(size_t& len) const {
+		size_t r = r_pos.load(std::memory_order_relaxed);
+		size_t avail = w_pos.load(std::memory_order_acquire) - r;
+		size_t offset = r & mask;
+
+		if (!avail) {
+			len = 0;
+			return nullptr;
+		}
+
+		if (avail > capacity - offset)
+			avail = capacity - offset;
+
+		if (len > avail)
+			len = avail;
+
+		return data + offset;
+	}
+
+	void spsc_ring_t::consume(size_t len) {
+		if (len) {
+			r_pos.store(r_pos.load(std::memory_order_relaxed) + len, std::memory_order_release);
+			wake(w_wait, w_seq);
+		}
+	}
+
+	bool spsc_ring_t::wait_readable(int32_t timeout) {
+		while (!get_size() && !is_closed()) {
+			uint32_t seq = r_seq.load(std::memory_order_acquire);
+
+			/* announce the waiter, then re-check: pairs with the fence in wake(). */
+			r_wait.store(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (get_size() || is_closed()) {
+				r_wait.store(0, std::memory_order_relaxed);
+				break;
+			}
+
+			if (!futex_t::wait(r_seq, seq, timeout))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool spsc_ring_t::wait_writable(int32_t timeout) {
+		while (!get_space() && !is_closed()) {
+			uint32_t seq = w_seq.load(std::memory_order_acquire);
+
+			w_wait.store(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (get_space() || is_closed()) {
+				w_wait.store(0, std::memory_order_relaxed);
+				break;
+			}
+
+			if (!futex_t::wait(w_seq, seq, timeout))
+				return false;
+		}
+
+		return true;
+	}
+
+	void spsc_ring_t::close() {
+		closed.store(true, std::memory_order_release);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		r_wait.store(0, std::memory_order_relaxed);
+		w_wait.store(0, std::memory_order_relaxed);
+
+		r_seq.fetch_add(1, std::memory_order_release);
+		w_seq.fetch_add(1, std::memory_order_release);
+
+		futex_t::wake_all(r_seq);
+		futex_t::wake_all(w_seq);
+	}
+
+	void spsc_ring_t::wake(std::atomic<uint32_t>& waiting, std::atomic<uint32_t>& seq) {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		/* fast path: nobody sleeps on the other side. */
+		if (!waiting.load(std::memory_order_relaxed))
+			return;
+
+		waiting.store(0, std::memory_order_relaxed);
+		seq.fetch_add(1, std::memory_order_release);
+		futex_t::wake_one(seq);
+	}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+#include "futex_t.hpp"
+
+namespace nhttp {
+namespace hal {
+
+	/**
+	 * class spsc_ring_t.
+	 * bounded byte ring for exactly one producer and one consumer.
+	 * reads and writes never lock; waiting sleeps on a futex only when empty or full.
+	 */
+	class NHTTP_API spsc_ring_t {
+	private:
+		uint8_t* data;
+		size_t capacity, mask;
+
+		/* producer and consumer cursors live on their own cache lines. */
+		alignas(64) std::atomic<size_t> w_pos;
+		alignas(64) std::atomic<size_t> r_pos;
+
+		alignas(64) std::atomic<uint32_t> r_seq, w_seq;
+		std::atomic<uint32_t> r_wait, w_wait;
+		std::atomic<bool> closed;
+
+	public:
+		/* capacity will be rounded up to power of two. */
+		spsc_ring_t(size_t capacity);
+		spsc_ring_t(const spsc_ring_t&) = delete;
+		spsc_ring_t(spsc_ring_t&&) = delete;
+		~spsc_ring_t();
+
+	public:
+		inline size_t get_capacity() const { return capacity; }
+
+		/* bytes written but not read yet. */
+		inline size_t get_size() const {
+			return w_pos.load(std::memory_order_acquire) - r_pos.load(std::memory_order_acquire);
+		}
+
+		/* bytes that can be written without waiting. */
+		inline size_t get_space() const { return capacity - get_size(); }
+
+		/* determines the ring is closed by either side or not. */
+		inline bool is_closed() const { return closed.load(std::memory_order_acquire); }
+
+	public:
+		/**
+		 * (producer) write bytes as many as possible.
+		 * @returns written bytes. (0 if full or closed)
+		 */
+		size_t write(const void* buf, size_t len);
+
+		/**
+		 * (producer) get contiguous writable span.
+		 * call `commit()` with filled bytes after writing into it.
+		 */
+		uint8_t* reserve(size_t& len);
+
+		/* (producer) publish bytes written into the reserved span. */
+		void commit(size_t len);
+
+		/**
+		 * (consumer) read bytes as many as possible.
+		 * @returns read bytes. (0 if empty)
+		 */
+		size_t read(void* buf, size_t len);
+
+		/**
+		 * (consumer) get contiguous readable span.
+		 * call `consume()` with used bytes after reading from it.
+		 */
+		const uint8_t* peek(size_t& len) const;
+
+		/* (consumer) release bytes read from the peeked span. */
+		void consume(size_t len);
+
+		/**
+		 * (consumer) sleep until bytes available or closed.
+		 * @returns false if timed out.
+		 */
+		bool wait_readable(int32_t timeout = -1);
+
+		/**
+		 * (producer) sleep until space available or closed.
+		 * @returns false if timed out.
+		 */
+		bool wait_writable(int32_t timeout = -1);
+
+		/**
+		 * close the ring and wake up both sides.
+		 * bytes already written can still be read.
+		 */
+		void close();
+
+	private:
+		void wake(std::atomic<uint32_t>& waiting, std::atomic<uint32_t>& seq);
+	};
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "vmem_raw_t.hpp"
+
+#if NHTTP_OS_WINDOWS
+#include <Windows.h>
+#endif
+#if NHTTP_OS_POSIX
+#include <sys/mman.h>
+#endif
+
+namespace nhttp {
+namespace hal {
+
+	inline size_t get_page_size() {
+#if NHTTP_OS_WINDOWS
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return size_t(info.dwPageSize);
+#else
+		long page = sysconf(_SC_PAGESIZE);
+		return page > 0 ? size_t(page) : 4096;
+#endif
+	}
+
+	inline size_t align_up(size_t value, size_t align) {
+		return ((value + align - 1) / align) * align;
+	}
+
+	bool vmem_raw_t::reserve(size_t size, bool huge_pages) {
+		release();
+
+		if (!size)
+			return false;
+
+#if NHTTP_OS_WINDOWS
+		if (huge_pages) {
+			size_t large = GetLargePageMinimum();
+
+			/* requires SeLockMemoryPrivilege, so this usually fails. */
+			if (large && (base = VirtualAlloc(nullptr, align_up(size, large),
+				MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE)))
+			{
+				this->size = align_up(size, large);
+				this->huge_pages = true;
+				return true;
+			}
+		}
+
+		size = align_up(size, get_page_size());
+		if (!(base = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)))
+			return false;
+#else
+#	if defined(MAP_HUGETLB)
+		if (huge_pages) {
+			size_t large = align_up(size, 2 * 1024 * 1024);
+			void* ptr = mmap(nullptr, large, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+			if (ptr != MAP_FAILED) {
+				this->base = ptr;
+				this->size = large;
+				this->huge_pages = true;
+				return true;
+			}
+		}
+#	endif
+
+		size = align_up(size, get_page_size());
+		void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (ptr == MAP_FAILED)
+			return false;
+
+#	if defined(MADV_HUGEPAGE)
+		/* no hugetlbfs pages reserved: ask for transparent huge pages instead. */
+		if (huge_pages)
+			madvise(ptr, size, MADV_HUGEPAGE);
+#	endif
+
+		base = ptr;
+#endif
+
+		this->size = size;
+		this->huge_pages = false;
+		return true;
+	}
+
+	void vmem_raw_t::prefault() {
+		if (!base)
+			return;
+
+		size_t page = get_page_size();
+		volatile uint8_t* cursor = (volatile uint8_t*)base;
+		volatile uint8_t* end = cursor + size;
+
+		while (cursor < end) {
+			*cursor = 0;
+			cursor += page;
+		}
+	}
+
+	void vmem_raw_t::release() {
+		if (base) {
+#if NHTTP_OS_WINDOWS
+			VirtualFree(base, 0, MEM_RELEASE);
+#else
+			munmap(base, size);
+#endif
+		}
+
+		base = nullptr;
+		size = 0;
+		huge_pages = false;
+	}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include "os/winapi.hpp"
+#include "os/posix.hpp"
+
+namespace nhttp {
+namespace hal {
+
+	/**
+	 * class vmem_raw_t.
+	 * wrapper for a reserved virtual memory region. (mmap, VirtualAlloc)
+	 */
+	class NHTTP_API vmem_raw_t {
+	private:
+		void* base;
+		size_t size;
+		bool huge_pages;
+
+	public:
+		vmem_raw_t() : base(nullptr), size(0), huge_pages(false) { }
+		vmem_raw_t(const vmem_raw_t&) = delete;
+		vmem_raw_t(vmem_raw_t&&) = delete;
+		~vmem_raw_t() { release(); }
+
+	public:
+		inline bool is_valid() const { return base != nullptr; }
+		inline void* get_base() const { return base; }
+		inline size_t get_size() const { return size; }
+
+		/* determines the region is backed by huge pages or not. */
+		inline bool is_huge_pages() const { return huge_pages; }
+
+	public:
+		/**
+		 * reserve and commit a region.
+		 * @param huge_pages try huge pages first, then fall back to normal pages.
+		 */
+		bool reserve(size_t size, bool huge_pages = true);
+
+		/* touch all pages of the region to pre-fault them. */
+		void prefault();
+
+		/* release the region. */
+		void release();
+	};
+
+}
+}
\ No newline at end of file
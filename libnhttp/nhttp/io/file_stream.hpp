@@ -64,10 +64,13 @@ namespace nhttp {
 			ssize_t v = fp ? ftell(fp) : 0;
 
 			if (fp) {
-				set_errno_c(errno); 
-				if (errno) {
+				/* errno is left as is on success: test the result instead. */
+				if (v < 0) {
+					set_errno_c(errno);
 					return -1;
 				}
+
+				set_errno_c(0);
 			}
 
 			else set_errno_c(ENOENT);
@@ -141,7 +144,7 @@ namespace nhttp {
 		}
 
 		/* flush internal buffers. */
-		virtual void flush() {
+		virtual void flush() override {
 			if (fp) {
 				fflush(fp);
 				set_errno(0);
@@ -150,8 +153,21 @@ namespace nhttp {
 			else set_errno(ENOENT);
 		}
 
+		/* get file descriptor and range of rest bytes. */
+		virtual bool get_file_span(int32_t& fd, int64_t& offset, int64_t& length) const override {
+			ssize_t pos = fp ? tell() : -1;
+
+			if (pos < 0 || get_length() < pos)
+				return false;
+
+			fd = int32_t(nhttp_fileno(fp));
+			offset = int64_t(pos);
+			length = int64_t(get_length() - pos);
+			return true;
+		}
+
 		/* close stream. */
-		virtual void close() { 
+		virtual void close() override { 
 			if (fp) {
 				fclose(fp);
 				set_errno(0);
@@ -9,6 +9,9 @@ namespace nhttp {
 		bool eof;
 		size_t cursor = 0;
 
+		/* size before the reserved span grew the memory. (SIZE_MAX: not reserved) */
+		size_t reserved_from = SIZE_MAX;
+
 	public:
 		memory_stream() : eof(true) { }
 		memory_stream(const std::vector<uint8_t>& mem)
@@ -25,7 +28,7 @@ namespace nhttp {
 		virtual bool is_valid() const override { return mem.size() > 0; }
 
 		/* determines this stream is based on non-blocking or not. */
-		virtual bool is_nonblock() const { return true; }
+		virtual bool is_nonblock() const override { return true; }
 
 		/**
 		 * set non-blocking.
@@ -33,7 +36,7 @@ namespace nhttp {
 		 *	= true : supported and set.
 		 *  = false: not supported.
 		 */
-		virtual bool set_nonblock(bool value) { return value; }
+		virtual bool set_nonblock(bool value) override { return value; }
 
 		/**
 		 * get total length of this stream.
@@ -137,7 +140,43 @@ namespace nhttp {
 			return int32_t(len);
 		}
 
-		virtual void close() {
+		/* get bytes at the cursor without copying. */
+		virtual const uint8_t* peek_span(size_t& len) const override {
+			size_t avail = mem.size() > cursor ? mem.size() - cursor : 0;
+
+			len = len > avail ? avail : len;
+			return len ? &mem[0] + cursor : nullptr;
+		}
+
+		virtual void consume(size_t len) override {
+			cursor = cursor + len > mem.size() ? mem.size() : cursor + len;
+			eof = cursor == mem.size();
+		}
+
+		/* get space at the cursor, growing the memory if needed. */
+		virtual uint8_t* reserve_span(size_t& len) override {
+			if (!len)
+				return nullptr;
+
+			reserved_from = mem.size();
+
+			if (mem.size() < cursor + len)
+				mem.resize(cursor + len, 0);
+
+			return &mem[0] + cursor;
+		}
+
+		/* the rest of the reserved span isn't kept. */
+		virtual void commit(size_t len) override {
+			cursor = cursor + len > mem.size() ? mem.size() : cursor + len;
+
+			if (reserved_from != SIZE_MAX && mem.size() > reserved_from && mem.size() > cursor)
+				mem.resize(reserved_from > cursor ? reserved_from : cursor);
+
+			reserved_from = SIZE_MAX;
+		}
+
+		virtual void close() override {
 			eof = true;
 			mem.clear();
 			cursor = 0;
@@ -0,0 +1,293 @@
+#pragma once
+#include "stream.hpp"
+#include "../hal/spsc_ring_t.hpp"
+#include "../hal/spinlock_t.hpp"
+
+namespace nhttp {
+	class push_writer;
+
+	/**
+	 * class push_stream.
+	 * read end of bytes pushed by `push_writer`, to be set as content of a response.
+	 * its length is unknown, so the response is sent with chunked encoding.
+	 */
+	class NHTTP_API push_stream : public stream {
+		friend class push_writer;
+
+	private:
+		struct shared_t {
+			hal::spsc_ring_t ring;
+			std::atomic<bool> aborted;
+
+			/* the reader waiting for bytes, instead of polling the ring. */
+			hal::spinlock_t spinlock;
+			std::function<void()> waker;
+
+			shared_t(size_t capacity)
+				: ring(capacity), aborted(false) { }
+
+			/* take the waker out, to call or drop it outside of the lock. */
+			inline std::function<void()> take_waker() {
+				std::function<void()> taken;
+				std::lock_guard<hal::spinlock_t> guard(spinlock);
+
+				std::swap(taken, waker);
+				return taken;
+			}
+
+			/* wake the reader once bytes are pushed or the ring is closed. */
+			inline void wake() {
+				if (auto waker = take_waker())
+					waker();
+			}
+		};
+
+		std::shared_ptr<shared_t> shared;
+		bool non_block;
+
+	public:
+		push_stream(const std::shared_ptr<shared_t>& shared)
+			: shared(shared), non_block(false) { }
+
+		/* the writer stops waiting once nobody reads. */
+		~push_stream() { close(); }
+
+	public:
+		/* determines validity of this stream. */
+		virtual bool is_valid() const override { return !shared->aborted.load(std::memory_order_acquire); }
+
+		/* determines currently at end of stream. */
+		virtual bool is_end_of() const override {
+			return shared->ring.is_closed() && !shared->ring.get_size();
+		}
+
+		/* determines this stream is based on non-blocking or not. */
+		virtual bool is_nonblock() const override { return non_block; }
+
+		/**
+		 * set non-blocking.
+		 * @returns:
+		 *	= true : supported and set.
+		 *  = false: not supported.
+		 */
+		virtual bool set_nonblock(bool value) override {
+			non_block = value;
+			return true;
+		}
+
+		/* determines this stream can be read immediately or not. */
+		virtual bool can_read() const override {
+			return shared->ring.get_size() > 0 || shared->ring.is_closed();
+		}
+
+		/* determines this stream can be written immediately or not. */
+		virtual bool can_write() const override { return false; }
+
+		/**
+		 * get total length of this stream.
+		 * @returns < 0: not known until the writer closes.
+		 */
+		virtual ssize_t get_length() const override {
+			set_errno_c(ENOTSUP);
+			return -1;
+		}
+
+		/* not supported. */
+		virtual ssize_t tell() const override {
+			set_errno_c(ENOTSUP);
+			return -1;
+		}
+
+		/* not supported. */
+		virtual bool seek(ssize_t off, int32_t orig) override {
+			set_errno(ENOTSUP);
+			return false;
+		}
+
+		/**
+		 * read bytes pushed by the writer.
+		 * @returns:
+		 *	> 0: read size.
+		 *  = 0: end of stream.
+		 *  < 0: nothing pushed yet, if non-block.
+		 * @note:
+		 *	errno == EWOULDBLOCK: for non-block mode.
+		 */
+		virtual int32_t read(void* buf, size_t len) override {
+			set_errno(0);
+
+			if (len > INT32_MAX)
+				len = INT32_MAX;
+
+			while (true) {
+				/* test closed before draining: bytes pushed before closing aren't lost. */
+				bool closed = shared->ring.is_closed();
+				size_t ret = shared->ring.read(buf, len);
+
+				if (ret > 0)
+					return int32_t(ret);
+
+				if (closed)
+					return 0;
+
+				if (non_block) {
+					set_errno(EWOULDBLOCK);
+					return -1;
+				}
+
+				shared->ring.wait_readable();
+			}
+		}
+
+		/* get bytes pushed into the ring without copying them. */
+		virtual const uint8_t* peek_span(size_t& len) const override {
+			const uint8_t* span = len ? shared->ring.peek(len) : nullptr;
+
+			if (!span)
+				len = 0;
+
+			return span;
+		}
+
+		/* the writer can reuse the space from now. */
+		virtual void consume(size_t len) override { shared->ring.consume(len); }
+
+		/* the writer calls `waker` when it pushes bytes or closes. */
+		virtual bool notify_readable(std::function<void()> waker) override {
+			std::lock_guard<hal::spinlock_t> guard(shared->spinlock);
+
+			/* bytes pushed before the lock are seen here, after it the writer wakes. */
+			if (can_read())
+				return false;
+
+			shared->waker = std::move(waker);
+			return true;
+		}
+
+		/* not supported: bytes are pushed by the writer. */
+		virtual int32_t write(const void* buf, size_t len) override {
+			set_errno(ENOTSUP);
+			return -1;
+		}
+
+		/* stop reading: the writer fails with EPIPE from now. */
+		virtual void close() override {
+			if (!shared->aborted.exchange(true, std::memory_order_acq_rel)) {
+				shared->ring.close();
+				shared->take_waker();
+			}
+		}
+	};
+
+	/**
+	 * class push_writer.
+	 * pushes bytes of a streaming response from a handler or a generator thread.
+	 * writes wait while the bytes not sent yet reach the high-water mark.
+	 */
+	class NHTTP_API push_writer {
+	private:
+		std::shared_ptr<push_stream::shared_t> shared;
+		std::shared_ptr<push_stream> reader;
+		int32_t err;
+
+	public:
+		/* @param high_water bytes that can be queued before writes wait. */
+		push_writer(size_t high_water = 64 * 1024)
+			: shared(std::make_shared<push_stream::shared_t>(high_water)), err(0)
+		{
+			reader = std::make_shared<push_stream>(shared);
+		}
+
+		push_writer(const push_writer&) = delete;
+		push_writer(push_writer&&) = delete;
+
+		/* the response ends when the writer is gone. */
+		~push_writer() { close(); }
+
+	public:
+		/* get error no. */
+		inline int32_t get_errno() const { return err; }
+
+		/* get the stream to set as response content, only once. */
+		inline std::shared_ptr<push_stream> get_stream() { return std::move(reader); }
+
+		/* determines the reader stopped reading or not. (the link is lost) */
+		inline bool is_aborted() const { return shared->aborted.load(std::memory_order_acquire); }
+
+		/* determines bytes can be written without waiting or not. */
+		inline bool can_write() const { return shared->ring.get_space() > 0 && !shared->ring.is_closed(); }
+
+		/* bytes queued but not read by the link yet. */
+		inline size_t get_pending() const { return shared->ring.get_size(); }
+
+		/**
+		 * wait until bytes can be written, the writer closed or the reader stopped.
+		 * @returns false if timed out.
+		 */
+		inline bool wait_writable(int32_t timeout = -1) { return shared->ring.wait_writable(timeout); }
+
+	public:
+		/**
+		 * write bytes without waiting.
+		 * @returns:
+		 *	>= 0: written size. (0 if above the high-water mark)
+		 *  <  0: closed or the reader stopped.
+		 * @note:
+		 *	errno == EPIPE: the reader stopped.
+		 */
+		inline int32_t try_write(const void* buf, size_t len) {
+			if (len > INT32_MAX)
+				len = INT32_MAX;
+
+			if (shared->ring.is_closed()) {
+				err = is_aborted() ? EPIPE : ENOENT;
+				return -1;
+			}
+
+			err = 0;
+			size_t ret = shared->ring.write(buf, len);
+
+			if (ret > 0)
+				shared->wake();
+
+			return int32_t(ret);
+		}
+
+		/**
+		 * write all bytes, waiting while above the high-water mark.
+		 * @returns:
+		 *	> 0: written size.
+		 *  < 0: closed or the reader stopped before all bytes written.
+		 * @note:
+		 *	errno == EPIPE: the reader stopped.
+		 */
+		inline int32_t write(const void* buf, size_t len) {
+			const uint8_t* cur = (const uint8_t*)buf;
+			size_t left = len > INT32_MAX ? INT32_MAX : len;
+			size_t total = left;
+
+			while (left) {
+				int32_t ret = try_write(cur, left);
+
+				if (ret < 0)
+					return -1;
+
+				cur += ret;
+				left -= size_t(ret);
+
+				if (left)
+					shared->ring.wait_writable();
+			}
+
+			return int32_t(total);
+		}
+
+		inline int32_t write(const std::string& str) { return write(str.c_str(), str.size()); }
+
+		/* end the response: bytes already written are still sent. */
+		inline void close() {
+			shared->ring.close();
+			shared->wake();
+		}
+	};
+}
\ No newline at end of file
@@ -58,7 +58,7 @@ namespace nhttp {
 		 *	>= 0: position.
 		 *  <  0: not supported.
 		 */
-		virtual ssize_t tell() const { return range_offset; }
+		virtual ssize_t tell() const override { return range_offset; }
 
 		/**
 		 * set current position of file cursor.
@@ -151,13 +151,50 @@ namespace nhttp {
 		}
 
 		/* flush internal buffers. */
-		virtual void flush() { 
+		virtual void flush() override { 
 			if (inner)
 				inner->flush();
 		}
 
+		/* get file descriptor and the rest of range. */
+		virtual bool get_file_span(int32_t& fd, int64_t& offset, int64_t& length) const override {
+			if (!inner || range_end < 0 || !inner->get_file_span(fd, offset, length))
+				return false;
+
+			offset = int64_t(range_offset);
+			length = int64_t(range_end - range_offset);
+			return true;
+		}
+
+		/* get bytes of the inner stream, limited to the rest of range. */
+		virtual const uint8_t* peek_span(size_t& len) const override {
+			if (range_end >= 0) {
+				size_t avail = size_t(range_end - range_offset);
+				len = len > avail ? avail : len;
+			}
+
+			if (!inner || !len) {
+				len = 0;
+				return nullptr;
+			}
+
+			return inner->peek_span(len);
+		}
+
+		virtual void consume(size_t len) override {
+			if (!inner)
+				return;
+
+			inner->consume(len);
+
+			if (range_end < 0)
+				eos = inner->is_end_of();
+
+			else range_offset += ssize_t(len);
+		}
+
 		/* close stream. */
-		virtual void close() {
+		virtual void close() override {
 			if (inner) {
 				inner->close();
 				inner = nullptr;
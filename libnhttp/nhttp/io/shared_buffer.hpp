@@ -0,0 +1,152 @@
+#pragma once
+#include "stream.hpp"
+
+namespace nhttp {
+
+	/**
+	 * class shared_buffer.
+	 * immutable bytes, shared by streams of concurrent responses without copying.
+	 */
+	class NHTTP_API shared_buffer {
+	private:
+		std::string bytes;
+
+	public:
+		shared_buffer(std::string&& bytes) : bytes(std::move(bytes)) { }
+		shared_buffer(const std::string& bytes) : bytes(bytes) { }
+		shared_buffer(const void* data, size_t size) : bytes((const char*)data, size) { }
+
+		shared_buffer(const shared_buffer&) = delete;
+		shared_buffer(shared_buffer&&) = delete;
+
+	public:
+		inline const uint8_t* data() const { return (const uint8_t*)bytes.data(); }
+		inline size_t size() const { return bytes.size(); }
+
+		/* make a buffer to share, taking the bytes of given string. */
+		static inline std::shared_ptr<const shared_buffer> make(std::string&& bytes) {
+			return std::make_shared<const shared_buffer>(std::move(bytes));
+		}
+
+		static inline std::shared_ptr<const shared_buffer> make(const void* data, size_t size) {
+			return std::make_shared<const shared_buffer>(data, size);
+		}
+	};
+
+	/**
+	 * class shared_buffer_stream.
+	 * read-only cursor over a shared buffer. each response has its own cursor.
+	 */
+	class NHTTP_API shared_buffer_stream : public stream {
+	private:
+		std::shared_ptr<const shared_buffer> buffer;
+		size_t cursor;
+
+	public:
+		shared_buffer_stream(const std::shared_ptr<const shared_buffer>& buffer)
+			: buffer(buffer), cursor(0) { }
+
+	public:
+		/* get the buffer this stream reads. */
+		inline const std::shared_ptr<const shared_buffer>& get_buffer() const { return buffer; }
+
+		/* determines validity of this stream. */
+		virtual bool is_valid() const override { return buffer != nullptr; }
+
+		/* determines currently at end of stream. */
+		virtual bool is_end_of() const override { return !buffer || cursor >= buffer->size(); }
+
+		/* determines this stream is based on non-blocking or not. */
+		virtual bool is_nonblock() const override { return true; }
+
+		/* reads never block. */
+		virtual bool set_nonblock(bool value) override { return value; }
+
+		/* not writable. */
+		virtual bool can_write() const override { return false; }
+
+		/**
+		 * get total length of this stream.
+		 * @returns:
+		 *	>= 0: length.
+		 */
+		virtual ssize_t get_length() const override { return buffer ? ssize_t(buffer->size()) : 0; }
+
+		/**
+		 * get current position of file cursor.
+		 * @returns:
+		 *	>= 0: position.
+		 */
+		virtual ssize_t tell() const override { return ssize_t(cursor); }
+
+		/**
+		 * set current position of file cursor.
+		 * @params: one of SEEK_SET, SEEK_CUR, SEEK_END
+		 * @returns false if not supported.
+		 */
+		virtual bool seek(ssize_t off, int32_t orig) override {
+			ssize_t size = get_length(), pos;
+
+			switch (orig) {
+			case SEEK_SET: pos = off; break;
+			case SEEK_CUR: pos = ssize_t(cursor) + off; break;
+			case SEEK_END: pos = size + off; break;
+			default:
+				set_errno(EINVAL);
+				return false;
+			}
+
+			cursor = size_t(pos < 0 ? 0 : (pos > size ? size : pos));
+			return true;
+		}
+
+		/**
+		 * read bytes from stream.
+		 * @returns:
+		 *	> 0: read size.
+		 *  = 0: end of stream.
+		 */
+		virtual int32_t read(void* buf, size_t len) override {
+			size_t avail = is_end_of() ? 0 : buffer->size() - cursor;
+
+			if (len > INT32_MAX)
+				len = INT32_MAX;
+
+			len = len > avail ? avail : len;
+			set_errno(0);
+
+			if (len) {
+				memcpy(buf, buffer->data() + cursor, len);
+				cursor += len;
+			}
+
+			return int32_t(len);
+		}
+
+		/* get bytes of the buffer at the cursor without copying. */
+		virtual const uint8_t* peek_span(size_t& len) const override {
+			size_t avail = is_end_of() ? 0 : buffer->size() - cursor;
+
+			len = len > avail ? avail : len;
+			return len ? buffer->data() + cursor : nullptr;
+		}
+
+		virtual void consume(size_t len) override {
+			size_t size = buffer ? buffer->size() : 0;
+			cursor = cursor + len > size ? size : cursor + len;
+		}
+
+		/* not supported: the buffer is immutable. */
+		virtual int32_t write(const void* buf, size_t len) override {
+			set_errno(ENOTSUP);
+			return -1;
+		}
+
+		/* drop the reference to the buffer. */
+		virtual void close() override {
+			buffer = nullptr;
+			cursor = 0;
+		}
+	};
+
+}
\ No newline at end of file
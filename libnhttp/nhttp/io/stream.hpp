@@ -109,6 +109,47 @@ namespace nhttp {
 		/* close stream. */
 		virtual void close() { }
 
+		/**
+		 * get file descriptor and range of rest bytes to send them without copying.
+		 * the stream isn't advanced: it should be dropped after the bytes sent.
+		 * @returns false if this stream isn't backed by a file.
+		 */
+		virtual bool get_file_span(int32_t& fd, int64_t& offset, int64_t& length) const { return false; }
+
+		/**
+		 * get contiguous bytes at the cursor to use them without copying. never blocks.
+		 * the span stays valid until `consume()` or other calls on this stream.
+		 * @param len maximum bytes to peek, set to bytes of the span.
+		 * @returns nullptr if not supported or nothing available now: use `read()` then.
+		 */
+		virtual const uint8_t* peek_span(size_t& len) const {
+			len = 0;
+			return nullptr;
+		}
+
+		/* advance the cursor over bytes of the peeked span. */
+		virtual void consume(size_t len) { }
+
+		/**
+		 * call `waker` once, from the thread that makes bytes readable, instead of being polled.
+		 * @returns false if not supported or readable already: read now.
+		 */
+		virtual bool notify_readable(std::function<void()> waker) { return false; }
+
+		/**
+		 * get contiguous space at the cursor to write bytes without copying.
+		 * the span stays valid until `commit()` or other calls on this stream.
+		 * @param len bytes to reserve, set to bytes of the span.
+		 * @returns nullptr if not supported: use `write()` then.
+		 */
+		virtual uint8_t* reserve_span(size_t& len) {
+			len = 0;
+			return nullptr;
+		}
+
+		/* advance the cursor over bytes written into the reserved span. */
+		virtual void commit(size_t len) { }
+
 	public:
 		inline bool read_all(std::string& out_string) {
 			size_t old_size = out_string.size();
@@ -7,6 +7,7 @@ namespace nhttp {
 	class socket_watcher;
 	using tcp = hal::tcp;
 	using udp = hal::udp;
+	using io_slice_t = hal::io_slice_t;
 
 	class socket_t {
 	public:
@@ -170,6 +171,30 @@ namespace nhttp {
 			return handle->raw.write(buf, n);
 		}
 
+		/* write slices at once but, non-blocking. */
+		inline ssize_t writev(const io_slice_t* slices, size_t count) {
+			NHTTP_INIT_ASSERT(handle, "socket isn't initialized!");
+			return handle->raw.writev(slices, count);
+		}
+
+		/* send bytes of a file without copying, non-blocking. */
+		inline ssize_t sendfile(int32_t file_fd, int64_t& offset, size_t count) {
+			NHTTP_INIT_ASSERT(handle, "socket isn't initialized!");
+			return handle->raw.sendfile(file_fd, offset, count);
+		}
+
+		/* get free bytes of send buffer, -1 if unknown. */
+		inline ssize_t get_send_space() const {
+			NHTTP_INIT_ASSERT(handle, "socket isn't initialized!");
+			return handle->raw.get_send_space();
+		}
+
+		/* hold partial frames while more bytes follow, sent when uncorked. */
+		inline bool set_cork_enabled(bool on) {
+			NHTTP_INIT_ASSERT(handle, "socket isn't initialized!");
+			return handle->raw.set_cork_enabled(on);
+		}
+
 		///* read n bytes explicitly, if under non-blocking, this works same with read() fn. */
 		//inline ssize_t read_n(void* buf, size_t n) {
 		//	NHTTP_INIT_ASSERT(handle, "socket isn't initialized!");
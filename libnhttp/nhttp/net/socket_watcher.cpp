@@ -16,6 +16,7 @@ namespace nhttp {
 			handle->flags.can_read = 0;
 			handle->flags.can_write = 0;
 
+			std::lock_guard<hal::spinlock_t> guard(spinlock);
 			handle->on_event = on_event;
 			handle->data_ptr = new socket_t(target);
 
@@ -41,6 +42,7 @@ namespace nhttp {
 			if (!handle->flags.io_mode)
 				return false;
 
+			std::lock_guard<hal::spinlock_t> guard(spinlock);
 			void* data_ptr = handle->data_ptr;
 			epoll.remove(handle->raw.get_fd());
 
@@ -58,6 +60,17 @@ namespace nhttp {
 		return false;
 	}
 
+	bool socket_watcher::watch_state_t::pause(const socket_t& sock, bool value) {
+		std::lock_guard<hal::spinlock_t> guard(spinlock);
+
+		/* unwatched already: its link is going away. */
+		if (!sock.handle || !sock.handle->data_ptr)
+			return false;
+
+		return epoll.modify(sock.handle->raw.get_fd(), EPOLLERR | EPOLLHUP | EPOLLRDHUP |
+			(value ? 0 : EPOLLIN | EPOLLOUT), sock.handle->data_ptr);
+	}
+
 	int32_t socket_watcher::watch_state_t::wait(socket_event* out_events, int32_t max_events, int32_t timeout) {
 		int slice = 0, skips = 0;
 
@@ -98,11 +111,9 @@ namespace nhttp {
 			}
 
 			else {
-				if ((event.events & EPOLLIN) != 0)
-					out_events->flags.can_read = flags.can_read = 1;
-
-				if ((event.events & EPOLLOUT) != 0)
-					out_events->flags.can_write = flags.can_write = 1;
+				/* level-triggered: reflect current readiness, not the history. */
+				out_events->flags.can_read = flags.can_read = (event.events & EPOLLIN) != 0;
+				out_events->flags.can_write = flags.can_write = (event.events & EPOLLOUT) != 0;
 
 				if ((event.events & EPOLLRDHUP) != 0)
 					out_events->flags.closed = flags.closed = 1;
@@ -1,5 +1,6 @@
 #pragma once
 #include "../hal/epoll_raw_t.hpp"
+#include "../hal/spinlock_t.hpp"
 #include "endpoint.hpp"
 #include "socket.hpp"
 
@@ -20,6 +21,7 @@ namespace nhttp {
 	private:
 		struct watch_state_t {
 			hal::epoll_raw_t epoll;
+			hal::spinlock_t spinlock; /* guards registrations against other threads. */
 			std::atomic<int32_t> sockets;
 			std::atomic<int64_t> waiters;
 
@@ -41,6 +43,9 @@ namespace nhttp {
 			bool watch(const socket_t& sock, void (*on_event)(socket_t));
 			bool unwatch(const socket_t& sock);
 
+			/* pause or resume readiness events of watched socket. */
+			bool pause(const socket_t& sock, bool value);
+
 			/* returns count of events. */
 			int32_t wait(socket_event* out_events, int32_t max_events, int32_t timeout);
 		};
@@ -67,6 +72,15 @@ namespace nhttp {
 			return state->unwatch(sock);
 		}
 
+		/**
+		 * stop reporting readiness of the socket until resumed, from any thread.
+		 * errors and hang-ups are still reported while paused.
+		 */
+		inline bool pause(const socket_t& sock, bool value = true) {
+			NHTTP_INIT_ASSERT(state, "tried to use uninitialized socket_watcher!");
+			return state->pause(sock, value);
+		}
+
 		inline int32_t wait(std::queue<socket_event>& out_events, int32_t timeout) {
 			NHTTP_INIT_ASSERT(state, "tried to use uninitialized socket_watcher!");
 			socket_event e[256];
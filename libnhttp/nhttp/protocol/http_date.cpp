@@ -109,16 +109,13 @@ namespace nhttp {
 		seconds = (src[6] - '0') * 10 + (src[7] - '0');
 		if (seconds < 0 || seconds >= 60) return -1; // allows 0 ~ 23.
 
-		struct tm _tm = { 0, };
+		/* days since the epoch, from the civil date. (proleptic gregorian) */
+		int32_t y = years - (month < 2), era = y / 400;
+		int32_t yoe = y - era * 400, m = (month + 10) % 12;
+		int32_t doy = (153 * m + 2) / 5 + day - 1;
+		int64_t days = int64_t(era) * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
 
-		_tm.tm_sec = seconds;
-		_tm.tm_min = minutes;
-		_tm.tm_hour = hours;
-		_tm.tm_mday = day;
-		_tm.tm_mon = month;
-		_tm.tm_year = years - 1900;
-
-		dst.timestamp = mktime(&_tm) - get_time_delta();
+		dst.timestamp = time_t(days * 86400 + hours * 3600 + minutes * 60 + seconds);
 		return int32_t(end + 3 - start);
 	}
 
@@ -126,10 +123,17 @@ namespace nhttp {
 		static const char* M2N[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
 		static const char* DoW[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
 
-		time_t timestamp = this->timestamp + get_time_delta();
-		struct tm now = *localtime(&timestamp);
+		struct tm now;
 		char temp[9];
 
+#if defined(_WIN32) || defined(_WIN64)
+		if (gmtime_s(&now, &timestamp))
+			return false;
+#else
+		if (!gmtime_r(&timestamp, &now))
+			return false;
+#endif
+
 		// ddd, (4) + ' ' * 5 + DD (1~2) + mmm (3) + YYYY (4) + HH:MM:SS (8) + GMT (3).
 		
 		out_string.append(DoW[now.tm_wday], 3);
@@ -165,4 +169,18 @@ namespace nhttp {
 		return true;
 	}
 
+	const std::string& http_date::cached(time_t timestamp) {
+		thread_local time_t last = -1;
+		thread_local std::string str;
+
+		if (last != timestamp || !str.size()) {
+			str.clear();
+
+			if (http_date(timestamp).stringify(str))
+				last = timestamp;
+		}
+
+		return str;
+	}
+
 }
\ No newline at end of file
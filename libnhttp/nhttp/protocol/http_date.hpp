@@ -37,6 +37,12 @@ namespace nhttp {
 			return out;
 		}
 
+		/**
+		 * get formatted string of given time, cached per thread.
+		 * re-formatted only when the second changes. (e.g. `Date` header of responses)
+		 */
+		static const std::string& cached(time_t timestamp);
+
 		/* get timestamp. */
 		inline time_t get_timestamp() const { return timestamp; }
 		inline time_t get_gmt_timestamp() const { return timestamp + get_time_delta(); }
@@ -23,6 +23,12 @@ namespace nhttp {
 		std::map<std::string, http_form_file> files;
 
 	public:
+		/* remove all fields and files. */
+		inline void clear() {
+			kv.value.clear();
+			files.clear();
+		}
+
 		/**
 		 * parse `urlencoded` data from http content.
 		 * @returns
@@ -2,6 +2,46 @@
 #include "../utils/strings.hpp"
 
 namespace nhttp {
+	/* all well-known headers, sorted by their ids at first use. */
+	static const http_header::well_known_t* WELL_KNOWNS[] = {
+		&http_header::TE, &http_header::AGE, &http_header::P3P, &http_header::HOST,
+		&http_header::DATE, &http_header::ETAG, &http_header::VARY, &http_header::LINK,
+		&http_header::ALLOW, &http_header::RANGE, &http_header::COOKIE, &http_header::ACCEPT,
+		&http_header::STATUS, &http_header::SERVER, &http_header::EXPECT, &http_header::PRAGMA,
+		&http_header::UPGRADE, &http_header::REFERER, &http_header::EXPIRES, &http_header::LOCATION,
+		&http_header::IF_MATCH, &http_header::IF_RANGE, &http_header::FORWARDED, &http_header::EXPECT_CT,
+		&http_header::CONNECTION, &http_header::SET_COOKIE, &http_header::USER_AGENT, &http_header::KEEP_ALIVE,
+		&http_header::CONTENT_TYPE, &http_header::LAST_MODIFIED, &http_header::AUTHORIZATION, &http_header::IF_NONE_MATCH,
+		&http_header::CACHE_CONTROL, &http_header::ACCEPT_RANGES, &http_header::CONTENT_RANGE, &http_header::CONTENT_LENGTH,
+		&http_header::ACCEPT_ENCODING, &http_header::ACCEPT_LANGUAGE, &http_header::REFERRER_POLICY, &http_header::X_FORWARDED_FOR,
+		&http_header::X_FRAME_OPTIONS, &http_header::WWW_AUTHENTICATE, &http_header::CONTENT_ENCODING, &http_header::CONTENT_LOCATION,
+		&http_header::X_XSS_PROTECTION, &http_header::IF_MODIFIED_SINCE, &http_header::TRANSFER_ENCODING, &http_header::X_FORWARDED_PROTO,
+		&http_header::IF_UNMODIFIED_SINCE, &http_header::SEC_WEBSOCKET_KEY, &http_header::SEC_WEBSOCKET_ACCEPT
+	};
+
+	uint32_t http_header::to_id(const char* name, size_t len) {
+		constexpr size_t count = sizeof(WELL_KNOWNS) / sizeof(WELL_KNOWNS[0]);
+		static const auto* sorted = []() {
+			std::sort(WELL_KNOWNS, WELL_KNOWNS + count,
+				[](const well_known_t* l, const well_known_t* r) { return l->_id < r->_id; });
+
+			return WELL_KNOWNS;
+		}();
+
+		uint32_t id = _::hash_header_name(name, len);
+		auto* found = std::lower_bound(sorted, sorted + count, id,
+			[](const well_known_t* l, uint32_t r) { return l->_id < r; });
+
+		/* hash matched: compare names to reject collisions. */
+		if (found != sorted + count && (*found)->_id == id &&
+			(*found)->_len == len && !strnicmp((*found)->_1, name, len))
+		{
+			return id;
+		}
+
+		return 0;
+	}
+
 	int32_t http_header::try_parse(http_header& dst, const char* src, size_t max, bool by_receiving) {
 		/**
 		* HEADER: (VALUE[;,]?)*
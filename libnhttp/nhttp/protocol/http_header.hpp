@@ -5,12 +5,30 @@
 
 namespace nhttp {
 namespace _ {
+	/* case-insensitive FNV-1a hash of header name. (never zero) */
+	constexpr uint32_t hash_header_name(const char* name, size_t len) {
+		uint32_t hash = 2166136261u;
+
+		for (size_t i = 0; i < len; ++i) {
+			char ch = name[i];
+
+			if (ch >= 'A' && ch <= 'Z')
+				ch += 'a' - 'A';
+
+			hash = (hash ^ uint8_t(ch)) * 16777619u;
+		}
+
+		return hash ? hash : 1;
+	}
+
 	struct well_known_header_t {
 		const char* _1;
 		size_t _len;
+		uint32_t _id;
 
 		template<size_t size>
-		constexpr well_known_header_t(const char(&name)[size]) : _1(name), _len(size - 1) { }
+		constexpr well_known_header_t(const char(&name)[size]) 
+			: _1(name), _len(size - 1), _id(hash_header_name(name, size - 1)) { }
 	};
 }
 	/**
@@ -83,18 +101,20 @@ namespace _ {
 	private:
 		std::string name;
 		std::string value;
+		uint32_t id; /* well-known header id, 0 if not well-known. */
 
 	public:
-		http_header() { }
-		http_header(const well_known_t& v) : name(v._1, v._len) { }
+		http_header() : id(0) { }
+		http_header(const well_known_t& v) : name(v._1, v._len), id(v._id) { }
+		http_header(const well_known_t& v, const std::string& value) : name(v._1, v._len), value(value), id(v._id) { }
 		http_header(const std::string& name, const std::string& value)
-			: name(name), value(value) { qualify(); }
+			: name(name), value(value) { qualify(); id = to_id(this->name.c_str(), this->name.size()); }
 
-		http_header(const http_header& h) : name(h.name), value(h.value) { }
-		http_header(http_header&& h) : name(std::move(h.name)), value(std::move(h.value)) { }
+		http_header(const http_header& h) : name(h.name), value(h.value), id(h.id) { }
+		http_header(http_header&& h) : name(std::move(h.name)), value(std::move(h.value)), id(h.id) { }
 
-		inline http_header& operator =(const http_header& o) { name = o.name; value = o.value; return *this; }
-		inline http_header& operator =(http_header&& o) { name = std::move(o.name); value = std::move(o.value); return *this; }
+		inline http_header& operator =(const http_header& o) { name = o.name; value = o.value; id = o.id; return *this; }
+		inline http_header& operator =(http_header&& o) { name = std::move(o.name); value = std::move(o.value); id = o.id; return *this; }
 
 	public:
 		inline operator bool() const { return name.size(); }
@@ -103,8 +123,8 @@ namespace _ {
 		inline bool operator ==(const http_header& m) const { return name.size() == m.name.size() && name == m.name && value.size() == m.value.size() && value == m.value; }
 		inline bool operator !=(const http_header& m) const { return name.size() != m.name.size() || name != m.name || value.size() != m.value.size() || value != m.value; }
 
-		inline bool operator ==(const well_known_t& w) const { return name.size() == w._len && name == w._1; }
-		inline bool operator !=(const well_known_t& w) const { return name.size() != w._len || name != w._1; }
+		inline bool operator ==(const well_known_t& w) const { return id == w._id; }
+		inline bool operator !=(const well_known_t& w) const { return id != w._id; }
 
 	public:
 		/**
@@ -123,12 +143,21 @@ namespace _ {
 		 */
 		bool stringify(std::string& out_string, bool with_crlf = true) const;
 
+		/**
+		 * resolve well-known header id from its name. (case-insensitive)
+		 * @returns 0 if the name isn't well-known.
+		 */
+		static uint32_t to_id(const char* name, size_t len);
+
 	public:
 		inline const std::string& get_name() const  { return name; }
 		inline const std::string& get_value() const { return value; }
+		inline uint32_t get_id() const { return id; }
 
-		inline void set_name(const std::string& name) { this->name = name; }
+		inline void set_name(const std::string& name) { this->name = name; id = to_id(name.c_str(), name.size()); }
 		inline void set_value(const std::string& value) { this->value = value; }
+		inline void set_name(const char* name, size_t len) { this->name.assign(name, len); id = to_id(name, len); }
+		inline void set_value(const char* value, size_t len) { this->value.assign(value, len); }
 
 	private:
 		/* trim whitespaces. */
@@ -1,16 +1,19 @@
 #include "http_headerset.hpp"
 
 namespace nhttp {
-	bool http_headers::stringify(std::string& out_string, bool with_crlf) {
-		if (vec.size()) {
-			std::sort(vec.begin(), vec.end(), 
-				[](const http_header& l, const http_header& r) {
-					return l.get_name().compare(r.get_name()) < 0;
-				});
+	bool http_headers::stringify(std::string& out_string, bool with_crlf) const {
+		size_t size = with_crlf ? 2 : 0;
 
-			for (const http_header& each : vec) {
-				each.stringify(out_string, true);
-			}
+		/* reserve once: headers are written in insertion order. */
+		for (const http_header& each : vec) {
+			if (each.get_value().size())
+				size += each.get_name().size() + each.get_value().size() + 4;
+		}
+
+		out_string.reserve(out_string.size() + size);
+
+		for (const http_header& each : vec) {
+			each.stringify(out_string, true);
 		}
 
 		if (with_crlf)
@@ -1,6 +1,7 @@
 #pragma once
 #include "http_header.hpp"
 #include "../utils/strings.hpp"
+#include "../utils/small_vector.hpp"
 
 namespace nhttp {
 	/**
@@ -9,11 +10,12 @@ namespace nhttp {
 	 */
 	class NHTTP_API http_headers {
 	public:
-		using iterator = typename std::vector<http_header>::iterator;
-		using const_iterator = typename std::vector<http_header>::const_iterator;
+		using container = utils::small_vector<http_header, 16>;
+		using iterator = typename container::iterator;
+		using const_iterator = typename container::const_iterator;
 
 	public:
-		std::vector<http_header> vec;
+		container vec;
 
 		http_headers() { }
 		http_headers(const http_headers& h) : vec(h.vec) { }
@@ -24,10 +26,10 @@ namespace nhttp {
 
 	public:
 		/**
-		 * stringify headers to generate http request.
+		 * stringify headers in the order they were set.
 		 * @returns always true.
 		 */
-		bool stringify(std::string& out_string, bool with_crlf = true);
+		bool stringify(std::string& out_string, bool with_crlf = true) const;
 
 	public:
 		/* determines header set or not. */
@@ -56,61 +58,77 @@ namespace nhttp {
 
 		/* set header. */
 		inline http_headers& set(const std::string& name, const std::string& value, bool replace = true) {
-			if (replace)
-				unset(name);
+			if (replace) {
+				auto item = find_one(name);
+
+				/* replace in place, then remove duplicates after it. */
+				if (item != vec.end()) {
+					const_cast<http_header&>(*item).set_value(value);
+					unset_after(item, name);
+					return *this;
+				}
+			}
 
-			vec.push_back(http_header(name, value));
+			vec.emplace_back(name, value);
 			return *this;
 		}
 
 		/* set header. */
 		inline http_headers& set(const http_header::well_known_t& name, const std::string& value, bool replace = true) {
-			http_header _header(name);
-			_header.set_value(value);
-
-			if (replace)
-				unset(name);
+			if (replace) {
+				auto item = find_one(name);
+
+				/* replace in place, then remove duplicates after it. */
+				if (item != vec.end()) {
+					const_cast<http_header&>(*item).set_value(value);
+					unset_after(item, name);
+					return *this;
+				}
+			}
 
-			vec.push_back(std::move(_header));
+			vec.emplace_back(name, value);
 			return *this;
 		}
 
 		/* find header by its name. */
 		inline const_iterator find_one(const std::string& name) const { return find_one(vec.cbegin(), name); }
 		inline const_iterator find_one(const_iterator from, const std::string& name) const {
-			if (from != vec.cend()) {
-				for (auto i = from; i != vec.cend(); ++i) {
-					const auto& each = i->get_name();
+			uint32_t id = http_header::to_id(name.c_str(), name.size());
 
-					if (each.size() == name.size() && !strnicmp(each.c_str(), name.c_str(), each.size())) {
-						return i;
-					}
+			for (auto i = from; i < vec.cend(); ++i) {
+				if (i->get_id() != id)
+					continue;
 
+				/* well-known ids are unique: no need to compare names. */
+				const auto& each = i->get_name();
+				if (id || (each.size() == name.size() && !strnicmp(each.c_str(), name.c_str(), each.size()))) {
+					return i;
 				}
 			}
+
 			return vec.cend();
 		}
 
 		/* find header by its name. */
 		inline const_iterator find_one(const http_header::well_known_t& name) const { return find_one(vec.cbegin(), name); }
 		inline const_iterator find_one(const_iterator from, const http_header::well_known_t& name) const {
-			if (from != vec.cend()) {
-				for (auto i = from; i != vec.cend(); ++i) {
-					if (*i == name) return i;
-				}
+			for (auto i = from; i < vec.cend(); ++i) {
+				if (i->get_id() == name._id) return i;
 			}
+
 			return vec.cend();
 		}
 
 		/* unset header by its name. */
 		inline bool unset(const std::string& name, bool all = true) {
+			uint32_t id = http_header::to_id(name.c_str(), name.size());
 			int32_t n = 0;
 
 			for (ssize_t i = ssize_t(vec.size()) - 1; i >= 0; --i) {
-				auto each = vec[i].get_name();
+				const auto& each = vec[i].get_name();
 
-				if (each.size() == name.size() && 
-					!strnicmp(each.c_str(), name.c_str(), each.size())) 
+				if (vec[i].get_id() == id && (id || (each.size() == name.size() &&
+					!strnicmp(each.c_str(), name.c_str(), each.size()))))
 				{
 					vec.erase(vec.begin() + i); ++n;
 
@@ -127,7 +145,7 @@ namespace nhttp {
 			int32_t n = 0;
 
 			for (ssize_t i = ssize_t(vec.size()) - 1; i >= 0; --i) {
-				if (vec[i] == name) {
+				if (vec[i].get_id() == name._id) {
 					vec.erase(vec.begin() + i); ++n;
 
 					if (!all)
@@ -138,5 +156,22 @@ namespace nhttp {
 			return n > 0;
 		}
 
+	private:
+		/* unset duplicated headers after the given one. */
+		template<typename name_type>
+		inline void unset_after(const_iterator item, const name_type& name) {
+			size_t index = size_t(item - vec.cbegin()) + 1;
+
+			while (index < vec.size()) {
+				auto next = find_one(vec.cbegin() + index, name);
+
+				if (next == vec.cend())
+					break;
+
+				index = size_t(next - vec.cbegin());
+				vec.erase(next);
+			}
+		}
+
 	};
 }
\ No newline at end of file
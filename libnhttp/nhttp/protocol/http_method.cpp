@@ -0,0 +1,44 @@
+#include "http_method.hpp"
+#include <algorithm>
+
+namespace nhttp {
+	/* find well-known method by its length and the first character. */
+	inline int32_t find_well_known(const char* name, size_t len) {
+		int32_t index = -1;
+
+		switch (len) {
+		case 3: index = (*name | 0x20) == 'g' ? 0 : 3; break;	/* GET, PUT */
+		case 4: index = (*name | 0x20) == 'h' ? 1 : 2; break;	/* HEAD, POST */
+		case 5: index = (*name | 0x20) == 't' ? 7 : 8; break;	/* TRACE, PATCH */
+		case 6: index = 4; break;								/* DELETE */
+		case 7: index = (*name | 0x20) == 'c' ? 5 : 6; break;	/* CONNECT, OPTIONS */
+		default: break;
+		}
+
+		if (index < 0 || strnicmp(name, http_method::ALL[index]._2, len))
+			return -1;
+
+		return index;
+	}
+
+	void http_method::parse(const char* name, size_t len) {
+		while (len && isspace((unsigned char)*name)) {
+			++name; --len;
+		}
+
+		while (len && isspace((unsigned char)name[len - 1]))
+			--len;
+
+		int32_t index = find_well_known(name, len);
+
+		if (index >= 0) {
+			well_id = ALL[index]._1;
+			flags = ALL[index]._3;
+			return;
+		}
+
+		/* extension method, compared in upper case. */
+		ext.assign(name, len);
+		std::transform(ext.begin(), ext.end(), ext.begin(), ::toupper);
+	}
+}
\ No newline at end of file
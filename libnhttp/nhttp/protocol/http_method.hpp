@@ -30,7 +30,7 @@ namespace nhttp {
 	 */
 	class NHTTP_API http_method {
 	private:
-		std::string name;
+		std::string ext;	/* name of extension method. */
 		int32_t well_id;
 		uint8_t flags;
 
@@ -60,51 +60,49 @@ namespace nhttp {
 
 	public:
 		http_method(invalid_t) : well_id(-1), flags(0) { }
-		http_method(well_known_t w) : name(w._2), well_id(w._1), flags(w._3) { }
-		http_method(const char* name) : name(name), well_id(-1), flags(0) { qualify(); }
-		http_method(const char* name, size_t len) : name(name, len), well_id(-1), flags(0) { qualify(); }
+		http_method(well_known_t w) : well_id(w._1), flags(w._3) { }
+		http_method(const char* name) : well_id(-1), flags(0) { parse(name, strlen(name)); }
+		http_method(const char* name, size_t len) : well_id(-1), flags(0) { parse(name, len); }
 
 	public:
-		inline operator bool() const { return name.size(); }
-		inline bool operator !() const { return !name.size(); }
+		inline operator bool() const { return !is_invalid(); }
+		inline bool operator !() const { return is_invalid(); }
 
-		inline bool operator ==(const invalid_t&) const { return !name.size(); }
-		inline bool operator !=(const invalid_t&) const { return  name.size(); }
+		inline bool operator ==(const invalid_t&) const { return  is_invalid(); }
+		inline bool operator !=(const invalid_t&) const { return !is_invalid(); }
 
-		inline bool operator ==(const http_method& m) const { return flags && m.flags ? well_id == m.well_id : name == m.name; }
-		inline bool operator !=(const http_method& m) const { return flags && m.flags ? well_id != m.well_id : name != m.name; }
+		inline bool operator ==(const http_method& m) const { return well_id == m.well_id && (well_id >= 0 || ext == m.ext); }
+		inline bool operator !=(const http_method& m) const { return !(*this == m); }
 
-		inline bool operator ==(const well_known_t& w) const { return well_id >= 0 ? well_id == w._1 : name == w._2; }
-		inline bool operator !=(const well_known_t& w) const { return well_id >= 0 ? well_id != w._1 : name != w._2; }
+		inline bool operator ==(const well_known_t& w) const { return well_id == w._1; }
+		inline bool operator !=(const well_known_t& w) const { return well_id != w._1; }
 
 		/* for std::map. */
-		inline bool operator <=(const http_method& m) const { return flags && m.flags ? well_id <= m.well_id : stricmp(name.c_str(), m.name.c_str()) <= 0; }
-		inline bool operator >=(const http_method& m) const { return flags && m.flags ? well_id >= m.well_id : stricmp(name.c_str(), m.name.c_str()) >= 0; }
-		inline bool operator < (const http_method& m) const { return flags && m.flags ? well_id <  m.well_id : stricmp(name.c_str(), m.name.c_str()) <  0; }
-		inline bool operator > (const http_method& m) const { return flags && m.flags ? well_id >  m.well_id : stricmp(name.c_str(), m.name.c_str()) >  0; }
+		inline bool operator <=(const http_method& m) const { return !(m < *this); }
+		inline bool operator >=(const http_method& m) const { return !(*this < m); }
+		inline bool operator < (const http_method& m) const { return well_id != m.well_id ? well_id < m.well_id : well_id < 0 && ext < m.ext; }
+		inline bool operator > (const http_method& m) const { return m < *this; }
 
 	public:
 		inline bool is(uint8_t flag) const { return (flags & flag) != 0; }
-		inline bool is_invalid() const { return !name.size(); }
+		inline bool is_invalid() const { return !*c_str(); }
 		inline bool is_well_known() const { return well_id >= 0; }
-		inline const char* c_str() const { return name.c_str(); }
-		inline size_t c_len() const { return name.size(); }
 
-	private:
-		/* trim whitespaces. */
-		inline void qualify() {
-			std::transform(name.begin(), name.end(), name.begin(), ::toupper); /* to upper and ltrim, rtrim. */
-			name.erase(name.begin(), std::find_if(name.begin(), name.end(), [](unsigned char ch) { return !std::isspace(ch); }));
-			name.erase(std::find_if(name.rbegin(), name.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(), name.end());
-
-			for (int32_t i = 0; i < ALL_COUNT; i++) {
-				if (!strcmp(ALL[i]._2, name.c_str())) {
-					well_id = ALL[i]._1;
-					flags = ALL[i]._3;
-					break;
-				}
-			}
+		/* get id of well-known method, -1 for extension methods. */
+		inline int32_t get_id() const { return well_id; }
+
+		inline const char* c_str() const {
+			if (well_id < 0)
+				return ext.c_str();
+
+			return size_t(well_id) < ALL_COUNT ? ALL[well_id]._2 : "";
 		}
+
+		inline size_t c_len() const { return well_id < 0 ? ext.size() : strlen(c_str()); }
+
+	private:
+		/* trim whitespaces and find well-known method. */
+		void parse(const char* name, size_t len);
 	};
 
 }
\ No newline at end of file
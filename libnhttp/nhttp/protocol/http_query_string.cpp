@@ -3,49 +3,148 @@
 namespace nhttp {
 
 	int32_t nhttp::http_query_string::try_parse(http_query_string& dst, const std::string& src) {
-		const char* src_s = src.c_str();
-		const char* src_e = src_s + src.size();
+		/* joined by '&', it will be split on first access. */
+		if (dst.raw.size())
+			dst.raw.push_back('&');
 
-		while (src_s < src_e) {
-			const char* src_m = (const char*)memchr(src_s, '&', size_t(src_e - src_s));
+		dst.raw.append(src);
+		return 0;
+	}
+
+	bool http_query_string::stringify(std::string& out) const {
+		parse();
 
-			if (!src_m) {
-				src_m = src_e;
+		for (const pair_t& pair : pairs) {
+			if (out.size()) {
+				out.push_back('&');
 			}
 
-			const char* kv_sep = (const char*)memchr(src_s, '=', size_t(src_m - src_s));
+			out.append(urlencode(key_of(pair)));
+			if (*value_of(pair)) {
+				out.push_back('=');
+				out.append(urlencode(value_of(pair)));
+			}
+		}
+
+		return true;
+	}
+
+	size_t http_query_string::count(const std::string& key) const {
+		size_t n = 0;
+
+		while (find(key, n))
+			++n;
+
+		return n;
+	}
+
+	void http_query_string::set(const std::string& key, const char* val, ssize_t len) {
+		pair_t pair;
+		parse();
+
+		if (len < 0)
+			len = ssize_t(strlen(val));
+
+		/* the terminator of the last value. */
+		if (raw.size())
+			raw.push_back('\0');
+
+		pair.key = uint32_t(raw.size());
+		pair.key_len = uint32_t(key.size());
+		raw.append(key).push_back('\0');
+
+		pair.value = uint32_t(raw.size());
+		pair.value_len = uint32_t(len);
+		raw.append(val, size_t(len));
+
+		pair.key_decoded = pair.value_decoded = 1;
+		pairs.push_back(pair);
+
+		parsed_len = raw.size();
+	}
+
+	void http_query_string::parse() const {
+		char* beg = &raw[0];
+		char* cur = beg + parsed_len;
+		char* end = beg + raw.size();
 
-			if (kv_sep) {
-				std::string key(src_s, size_t(kv_sep - src_s));
-				std::string val(kv_sep + 1, size_t(src_m - kv_sep - 1));
-				dst.kv.emplace(urldecode(key), urldecode(val));
+		while (cur < end) {
+			char* amp = (char*)memchr(cur, '&', size_t(end - cur));
+
+			if (!amp) {
+				amp = end;
 			}
 
-			else {
-				std::string key(src_s, size_t(src_m - src_s));
-				dst.kv.emplace(urldecode(key), "");
+			/* skip empty pairs. */
+			if (amp > cur) {
+				char* eq = (char*)memchr(cur, '=', size_t(amp - cur));
+				pair_t pair;
+
+				pair.key = uint32_t(cur - beg);
+				pair.key_len = uint32_t((eq ? eq : amp) - cur);
+				pair.value = uint32_t((eq ? eq + 1 : amp) - beg);
+				pair.value_len = eq ? uint32_t(amp - eq - 1) : 0;
+				pair.key_decoded = pair.value_decoded = 0;
+
+				if (eq)
+					*eq = '\0';
+
+				pairs.push_back(pair);
 			}
 
-			src_s = src_m + 1;
+			if (amp < end)
+				*amp = '\0';
+
+			cur = amp + 1;
 		}
 
-		return 0;
+		parsed_len = raw.size();
 	}
 
-	bool http_query_string::stringify(std::string& out) const {
-		for (const auto& pair : kv) {
-			if (out.size()) {
-				out.push_back('&');
+	const http_query_string::pair_t* http_query_string::find(const std::string& key, size_t nth) const {
+		parse();
+
+		for (const pair_t& pair : pairs) {
+			key_of(pair);
+
+			if (pair.key_len == key.size() && !memcmp(&raw[pair.key], key.c_str(), key.size()) && !nth--)
+				return &pair;
+		}
+
+		return nullptr;
+	}
+
+	const char* http_query_string::key_of(const pair_t& pair) const {
+		if (!pair.key_decoded) {
+			pair_t& temp = const_cast<pair_t&>(pair);
+			char* key = &raw[pair.key];
+
+			/* decode in place, it can't be longer than raw bytes. */
+			if (needs_urldecode(key, pair.key_len)) {
+				temp.key_len = uint32_t(urldecode_inplace(key, pair.key_len));
+				key[temp.key_len] = '\0';
 			}
 
-			out.append(urlencode(pair.first));
-			if (pair.second.size()) {
-				out.push_back('=');
-				out.append(urlencode(pair.second));
+			temp.key_decoded = 1;
+		}
+
+		return &raw[pair.key];
+	}
+
+	const char* http_query_string::value_of(const pair_t& pair) const {
+		if (!pair.value_decoded) {
+			pair_t& temp = const_cast<pair_t&>(pair);
+			char* value = &raw[pair.value];
+
+			if (needs_urldecode(value, pair.value_len)) {
+				temp.value_len = uint32_t(urldecode_inplace(value, pair.value_len));
+				value[temp.value_len] = '\0';
 			}
+
+			temp.value_decoded = 1;
 		}
 
-		return true;
+		return &raw[pair.value];
 	}
 
 }
\ No newline at end of file
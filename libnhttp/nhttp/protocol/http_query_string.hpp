@@ -1,6 +1,7 @@
 #pragma once
 #include "../types.hpp"
 #include "../utils/urlencode.hpp"
+#include "../utils/small_vector.hpp"
 
 namespace nhttp {
 
@@ -8,10 +9,22 @@ namespace nhttp {
 	 * class http_query_string.
 	 * parse or stringify URI query string.
 	 * this can handle application/www-urlencoded.
+	 * pairs are split on first access and decoded in place when they are touched.
 	 */
 	class NHTTP_API http_query_string {
-	public:
-		std::map<std::string, std::string> kv;
+	private:
+		/* offsets of a pair in raw bytes. */
+		struct pair_t {
+			uint32_t key, key_len;
+			uint32_t value, value_len;
+
+			int8_t key_decoded : 1;
+			int8_t value_decoded : 1;
+		};
+
+		mutable std::string raw;
+		mutable utils::small_vector<pair_t, 8> pairs;
+		mutable size_t parsed_len = 0;
 
 	public:
 		/**
@@ -29,23 +42,44 @@ namespace nhttp {
 		}
 
 	public:
-		inline bool has(const std::string& key) const { return kv.find(key) != kv.end(); }
-		
-		/* @warn: don't store returned pointer! */
-		inline const char* get(const std::string& key) const {
-			auto elem = kv.find(key);
+		inline bool has(const std::string& key) const { return find(key, 0) != nullptr; }
 
-			if (elem != kv.end())
-				return elem->second.c_str();
+		/* count values of the key. */
+		size_t count(const std::string& key) const;
+
+		/**
+		 * get `nth` value of the key.
+		 * @warn: don't store returned pointer!
+		 */
+		inline const char* get(const std::string& key, size_t nth = 0) const {
+			if (const pair_t* pair = find(key, nth))
+				return value_of(*pair);
 
 			return nullptr;
 		}
 
-		inline void set(const std::string& key, const char* val, ssize_t len = -1) {
-			if (len < 0)
-				 kv.emplace(key, std::string(val));
-			else kv.emplace(key, std::string(val, len));
+		/* get count of pairs and each pair. */
+		inline size_t size() const { parse(); return pairs.size(); }
+		inline const char* get_key(size_t i) const { parse(); return key_of(pairs[i]); }
+		inline const char* get_value(size_t i) const { parse(); return value_of(pairs[i]); }
+
+		/* add a pair. (no escaped) */
+		void set(const std::string& key, const char* val, ssize_t len = -1);
+
+		/* remove all pairs. (the buffer keeps its capacity) */
+		inline void clear() {
+			raw.clear();
+			pairs.clear();
+			parsed_len = 0;
 		}
+
+	private:
+		/* split raw bytes which aren't parsed yet. */
+		void parse() const;
+
+		const pair_t* find(const std::string& key, size_t nth) const;
+		const char* key_of(const pair_t& pair) const;
+		const char* value_of(const pair_t& pair) const;
 	};
 
 }
\ No newline at end of file
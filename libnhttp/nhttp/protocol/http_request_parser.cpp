@@ -0,0 +1,373 @@
+#include "http_request_parser.hpp"
+
+namespace nhttp {
+	/**
+	 * find the first `delim` in the line, or the line feed if the line has no `delim`.
+	 * `delim` comes first on well-formed lines, so the line feed is only searched before it.
+	 */
+	inline const char* find_in_line(const char* cur, const char* end, char delim) {
+		const char* found = (const char*)memchr(cur, delim, size_t(end - cur));
+		const char* lf = (const char*)memchr(cur, '\n', size_t((found ? found : end) - cur));
+
+		return lf ? lf : found;
+	}
+
+	/* trim trailing whitespaces and CR. */
+	inline size_t trim_tail(const char* str, size_t len) {
+		while (len && (str[len - 1] == ' ' || str[len - 1] == '\t' || str[len - 1] == '\r'))
+			--len;
+
+		return len;
+	}
+
+	/* determines comma-separated list has given token or not. */
+	inline bool has_token(const char* list, size_t list_len, const char* token, size_t len) {
+		const char* cur = list;
+		const char* end = cur + list_len;
+
+		while (cur < end) {
+			while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == ','))
+				++cur;
+
+			const char* beg = cur;
+
+			while (cur < end && *cur != ',')
+				++cur;
+
+			const char* tail = cur;
+
+			while (tail > beg && (tail[-1] == ' ' || tail[-1] == '\t'))
+				--tail;
+
+			if (size_t(tail - beg) == len && !strnicmp(beg, token, len))
+				return true;
+		}
+
+		return false;
+	}
+
+	http_request_parser::http_request_parser(size_t limit)
+		: target(nullptr), headers(nullptr), bytes(0), line_at(0), status(0), phase(PHASE_ERROR)
+	{
+		memset(&limits, 0, sizeof(limits));
+		limits.total = limit;
+
+		framing.content_length = -1;
+		framing.host = -1;
+		framing.chunked = framing.bad_coding = framing.keep_alive = framing.upgrade = framing.expect_continue = 0;
+	}
+
+	void http_request_parser::begin(http_resource& target, http_headers& headers) {
+		this->target = &target;
+		this->headers = &headers;
+
+		token.clear();
+
+		bytes = line_at = 0;
+		status = 0;
+		phase = PHASE_METHOD;
+
+		framing.content_length = -1;
+		framing.host = -1;
+		framing.chunked = framing.bad_coding = framing.upgrade = framing.expect_continue = 0;
+		framing.keep_alive = 1;
+	}
+
+	int32_t http_request_parser::fail(int16_t status) {
+		this->status = status;
+		phase = PHASE_ERROR;
+		return PARSE_ERROR;
+	}
+
+	const char* http_request_parser::take(const char*& cur, const char* end, const char* found, size_t& len) {
+		/* fast path: whole token is in the input. */
+		if (found && !token.size()) {
+			const char* ret = cur;
+
+			len = size_t(found - cur);
+			cur = found + 1;
+			return ret;
+		}
+
+		token.append(cur, size_t((found ? found : end) - cur));
+		cur = found ? found + 1 : end;
+
+		if (!found)
+			return nullptr;
+
+		len = token.size();
+		return token.c_str();
+	}
+
+	int32_t http_request_parser::parse(const void* data, size_t len, size_t& used) {
+		const char* beg = (const char*)data;
+		const char* cur = beg, *end = beg + len;
+		int32_t ret = PARSE_AGAIN;
+
+		/* limits can't be exceeded by this call if all given bytes fit in them. */
+		bool checks = may_exceed(bytes + len);
+
+		if (phase == PHASE_DONE || phase == PHASE_ERROR) {
+			used = 0;
+			return phase == PHASE_DONE ? PARSE_DONE : PARSE_ERROR;
+		}
+
+		while (cur < end && ret == PARSE_AGAIN) {
+			const char* found, *tok;
+			size_t tok_len = 0;
+
+			switch (phase) {
+			case PHASE_METHOD:
+				/* ignore empty lines before request line. (RFC 7230, 3.5) */
+				if (!token.size() && (*cur == '\r' || *cur == '\n')) {
+					++cur;
+					break;
+				}
+
+				found = find_in_line(cur, end, ' ');
+
+				if ((tok = take(cur, end, found, tok_len)) != nullptr) {
+					if (*found != ' ' || !tok_len)
+						ret = fail(400);
+
+					else {
+						target->set_method(http_method(tok, tok_len));
+						token.clear();
+						phase = PHASE_TARGET;
+					}
+				}
+				break;
+
+			case PHASE_TARGET:
+				found = find_in_line(cur, end, ' ');
+
+				if ((tok = take(cur, end, found, tok_len)) != nullptr) {
+					if (*found != ' ' || !tok_len)
+						ret = fail(400);
+
+					else {
+						target->set_path(tok, tok_len);
+						token.clear();
+						phase = PHASE_VERSION;
+					}
+				}
+				break;
+
+			case PHASE_VERSION:
+				found = (const char*)memchr(cur, '\n', size_t(end - cur));
+
+				if ((tok = take(cur, end, found, tok_len)) != nullptr) {
+					if (!on_version(tok, trim_tail(tok, tok_len)))
+						ret = fail(400);
+
+					/* the whole line may arrive at once. */
+					else if (limits.line && bytes + size_t(cur - beg) > limits.line)
+						ret = fail(414);
+
+					else {
+						token.clear();
+						phase = PHASE_LINE;
+					}
+				}
+				break;
+
+			case PHASE_LINE:
+				if (*cur == '\r') {
+					phase = PHASE_LAST_LF;
+					++cur;
+				}
+
+				else if (*cur == '\n') {
+					phase = PHASE_DONE;
+					ret = PARSE_DONE;
+					++cur;
+				}
+
+				/* obsolete line folding isn't accepted. (RFC 7230, 3.2.4) */
+				else if (*cur == ' ' || *cur == '\t')
+					ret = fail(400);
+
+				else if (limits.headers && headers->vec.size() >= limits.headers)
+					ret = fail(431);
+
+				else {
+					line_at = bytes + size_t(cur - beg);
+					phase = PHASE_NAME;
+				}
+				break;
+
+			case PHASE_NAME:
+				found = find_in_line(cur, end, ':');
+
+				if ((tok = take(cur, end, found, tok_len)) != nullptr) {
+					tok_len = trim_tail(tok, tok_len);
+
+					if (*found != ':' || !tok_len)
+						ret = fail(400);
+
+					else {
+						headers->vec.emplace_back().set_name(tok, tok_len);
+						token.clear();
+						phase = PHASE_VALUE_LWS;
+					}
+				}
+				break;
+
+			case PHASE_VALUE_LWS:
+				while (cur < end && (*cur == ' ' || *cur == '\t'))
+					++cur;
+
+				if (cur < end)
+					phase = PHASE_VALUE;
+				break;
+
+			case PHASE_VALUE:
+				found = (const char*)memchr(cur, '\n', size_t(end - cur));
+
+				if ((tok = take(cur, end, found, tok_len)) != nullptr) {
+					int16_t code = on_header(tok, trim_tail(tok, tok_len));
+
+					/* the whole line may arrive at once. */
+					if (!code && limits.header && bytes + size_t(cur - beg) - line_at > limits.header)
+						code = 431;
+
+					if (code)
+						ret = fail(code);
+
+					else {
+						token.clear();
+						phase = PHASE_LINE;
+					}
+				}
+				break;
+
+			case PHASE_LAST_LF:
+				if (*cur != '\n')
+					ret = fail(400);
+
+				else {
+					phase = PHASE_DONE;
+					ret = PARSE_DONE;
+					++cur;
+				}
+				break;
+			}
+
+			/* stop as soon as a limit is exceeded, before taking more bytes. */
+			if (ret == PARSE_AGAIN && checks) {
+				int16_t code = check_limits(bytes + size_t(cur - beg));
+
+				if (code)
+					ret = fail(code);
+			}
+		}
+
+		used = size_t(cur - beg);
+		bytes += used;
+
+		if (ret != PARSE_ERROR && limits.total && bytes > limits.total)
+			return fail(431);
+
+		return ret;
+	}
+
+	bool http_request_parser::may_exceed(size_t at) const {
+		return (limits.line && phase <= PHASE_VERSION && at > limits.line) ||
+			(limits.total && at > limits.total) ||
+			(limits.header && at - line_at > limits.header);
+	}
+
+	int16_t http_request_parser::check_limits(size_t at) const {
+		/* 414 URI Too Long. */
+		if (phase <= PHASE_VERSION && limits.line && at > limits.line)
+			return 414;
+
+		/* 431 Request Header Fields Too Large. */
+		if (limits.total && at > limits.total)
+			return 431;
+
+		if (limits.header && phase >= PHASE_NAME && phase <= PHASE_VALUE && at - line_at > limits.header)
+			return 431;
+
+		return 0;
+	}
+
+	bool http_request_parser::on_version(const char* version, size_t len) {
+		/* HTTP/1.x only. */
+		if (len != 8 || strnicmp(version, "HTTP/1.", 7) ||
+			version[7] < '0' || version[7] > '9')
+		{
+			return false;
+		}
+
+		target->set_major_ver(1);
+		target->set_minor_ver(version[7] - '0');
+
+		/* HTTP/1.0 closes the connection by default. */
+		framing.keep_alive = version[7] != '0';
+		return true;
+	}
+
+	int16_t http_request_parser::on_header(const char* value, size_t len) {
+		http_header& header = headers->vec.back();
+		header.set_value(value, len);
+
+		if (header == http_header::CONTENT_LENGTH) {
+			int64_t length = 0;
+
+			if (!len || len > 18)
+				return 400;
+
+			for (size_t i = 0; i < len; ++i) {
+				if (value[i] < '0' || value[i] > '9')
+					return 400;
+
+				length = length * 10 + (value[i] - '0');
+			}
+
+			/* conflicting lengths can be used for request smuggling. */
+			if (framing.content_length >= 0 && framing.content_length != length)
+				return 400;
+
+			framing.content_length = length;
+
+			/* 413 Payload Too Large. */
+			if (limits.content && length > limits.content)
+				return 413;
+		}
+
+		else if (header == http_header::TRANSFER_ENCODING) {
+			/* chunked should be the final coding. */
+			framing.chunked = len >= 7 && !strnicmp(value + len - 7, "chunked", 7);
+			framing.bad_coding = !framing.chunked && (len != 8 || strnicmp(value, "identity", 8));
+		}
+
+		else if (header == http_header::CONNECTION) {
+			if (has_token(value, len, "close", 5))
+				framing.keep_alive = 0;
+
+			else if (has_token(value, len, "keep-alive", 10))
+				framing.keep_alive = 1;
+		}
+
+		else if (header == http_header::UPGRADE)
+			framing.upgrade = 1;
+
+		/* 417 Expectation Failed if unknown, ignored for HTTP/1.0. (RFC 7231, 5.1.1) */
+		else if (header == http_header::EXPECT) {
+			if (len != 12 || strnicmp(value, "100-continue", 12))
+				return 417;
+
+			framing.expect_continue = target->get_minor_ver() > 0;
+		}
+
+		else if (header == http_header::HOST) {
+			if (framing.host >= 0)
+				return 400;
+
+			framing.host = ssize_t(headers->vec.size() - 1);
+		}
+
+		return 0;
+	}
+}
\ No newline at end of file
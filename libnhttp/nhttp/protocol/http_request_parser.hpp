@@ -0,0 +1,119 @@
+#pragma once
+#include "http_resource.hpp"
+#include "http_headerset.hpp"
+
+namespace nhttp {
+	/**
+	 * class http_request_parser.
+	 * resumable parser for request line and headers.
+	 * consumes each byte once and picks framing headers up while parsing.
+	 */
+	class NHTTP_API http_request_parser {
+	public:
+		enum {
+			PARSE_AGAIN = 0,	/* more bytes required. */
+			PARSE_DONE,			/* request line and headers are parsed. */
+			PARSE_ERROR			/* malformed or too large, see get_status(). */
+		};
+
+	private:
+		enum {
+			PHASE_METHOD = 0,
+			PHASE_TARGET,
+			PHASE_VERSION,
+			PHASE_LINE,
+			PHASE_NAME,
+			PHASE_VALUE_LWS,
+			PHASE_VALUE,
+			PHASE_LAST_LF,
+			PHASE_DONE,
+			PHASE_ERROR
+		};
+
+		http_resource* target;
+		http_headers* headers;
+
+		/* partial token, kept across calls. */
+		std::string token;
+
+		/* bytes consumed and offset where the current header line began. */
+		size_t bytes, line_at;
+		int16_t status;
+		int8_t phase;
+
+	public:
+		/* limits of request line and headers, 0 for unlimited. */
+		struct limits_t {
+			size_t line;			/* bytes of request line. (414) */
+			size_t header;			/* bytes of each header line. (431) */
+			size_t headers;			/* count of headers. (431) */
+			size_t total;			/* bytes of request line and headers. (431) */
+			int64_t content;		/* value of `Content-Length` header. (413) */
+		};
+
+	private:
+		limits_t limits;
+
+	public:
+		/* framing headers, valid after PARSE_DONE. */
+		struct framing_t {
+			int64_t content_length;	/* -1 if not set. */
+			ssize_t host;			/* index of Host header, -1 if not set. */
+
+			int8_t chunked : 1;		/* transfer-coding is chunked. */
+			int8_t bad_coding : 1;	/* transfer-coding is neither chunked nor identity. */
+			int8_t keep_alive : 1;
+			int8_t upgrade : 1;		/* `Upgrade` header is set. */
+			int8_t expect_continue : 1;	/* the client waits `100 Continue` before sending content. */
+		} framing;
+
+	public:
+		/* @param limit maximum bytes of request line and headers. (0: unlimited) */
+		http_request_parser(size_t limit = 0);
+
+	public:
+		/* get status code to respond on PARSE_ERROR. */
+		inline int32_t get_status() const { return status; }
+
+		/* determines nothing has been consumed since begin() or not. */
+		inline bool is_idle() const { return phase == PHASE_METHOD && !bytes; }
+
+		/* set maximum bytes of request line and headers. */
+		inline void set_limit(size_t limit) { limits.total = limit; }
+
+		/* set all limits at once. */
+		inline void set_limits(const limits_t& limits) { this->limits = limits; }
+		inline const limits_t& get_limits() const { return limits; }
+
+	public:
+		/* reset the parser to fill given target and headers. */
+		void begin(http_resource& target, http_headers& headers);
+
+		/**
+		 * parse bytes, resuming from the previous call.
+		 * @param used consumed bytes. bytes after the headers are left unconsumed.
+		 * @returns one of PARSE_AGAIN, PARSE_DONE and PARSE_ERROR.
+		 */
+		int32_t parse(const void* data, size_t len, size_t& used);
+
+	private:
+		int32_t fail(int16_t status);
+
+		/**
+		 * take bytes until `found` as a token.
+		 * the token refers the input directly if it isn't split across calls.
+		 */
+		const char* take(const char*& cur, const char* end, const char* found, size_t& len);
+
+		/* determines bytes until `at` can exceed limits or not. */
+		bool may_exceed(size_t at) const;
+
+		/* check limits of the line being parsed, 0 if not exceeded. */
+		int16_t check_limits(size_t at) const;
+
+		bool on_version(const char* version, size_t len);
+
+		/* @returns 0 if accepted, otherwise status code to respond. */
+		int16_t on_header(const char* value, size_t len);
+	};
+}
\ No newline at end of file
@@ -69,18 +69,32 @@ namespace nhttp {
 		inline void set_major_ver(int32_t v) { _ver_major = v; }
 		inline void set_minor_ver(int32_t v) { _ver_minor = v; }
 
+		/* reset to the default resource in place. (strings keep their capacity) */
+		inline void clear() {
+			_method = http_method::NONE;
+			_path.assign(1, '/');
+			_query_string.clear();
+			_full_path.clear();
+			_ver_major = _ver_minor = 1;
+		}
+
 		/* set method and path string. */
 		inline void set_method(const http_method& _method) { this->_method = _method; }
-		inline void set_path(const std::string& path) {
-			size_t s = path.find_first_of('?');
-			_full_path = path;
-
-			if (s != std::string::npos) {
-				_query_string = path.substr(s + 1);
-				_path = urldecode(path.substr(0, s));
+		inline void set_path(const std::string& path) { set_path(path.c_str(), path.size()); }
+		inline void set_path(const char* path, size_t len) {
+			const char* s = (const char*)memchr(path, '?', len);
+			_full_path.assign(path, len);
+
+			if (s) {
+				_query_string.assign(s + 1, size_t(path + len - s - 1));
+				_path.assign(path, size_t(s - path));
 			}
 
-			else _path = urldecode(path);
+			else _path.assign(path, len);
+
+			/* decode in place only if escaped. */
+			if (needs_urldecode(_path.c_str(), _path.size()))
+				_path.resize(urldecode_inplace(&_path[0], _path.size()));
 		}
 
 		/* set query string. */
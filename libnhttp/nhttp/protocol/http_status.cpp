@@ -2,10 +2,31 @@
 
 namespace nhttp {
 
+	/* pre-rendered `HTTP/1.1 ZZZ PHRASE\r\n` lines of well-known status codes. */
+	struct http_status_lines {
+		std::string lines[http_status::ALL_COUNT];
+
+		http_status_lines() {
+			for (size_t i = 0; i < http_status::ALL_COUNT; ++i) {
+				const auto& each = http_status::ALL[i];
+				std::string& line = lines[i];
+
+				line.reserve(15 + each._len);
+				line.append("HTTP/1.1 ", 9);
+				line.push_back(char('0' + each._1 / 100));
+				line.push_back(char('0' + (each._1 / 10) % 10));
+				line.push_back(char('0' + each._1 % 10));
+				line.push_back(' ');
+				line.append(each._2, each._len);
+				line.append("\r\n", 2);
+			}
+		}
+	};
+
 	void http_status::set_default_phrase(http_status& status, int16_t code) {
 		for (int32_t i = 0; i < ALL_COUNT; ++i) {
 			if (ALL[i]._1 == code) {
-				status.phrase = std::string(ALL[i]._2, ALL[i]._len);
+				status.phrase.assign(ALL[i]._2, ALL[i]._len);
 				break;
 			}
 		}
@@ -66,9 +87,32 @@ namespace nhttp {
 	*/
 
 	bool http_status::stringify(std::string& out_string, bool with_crlf) const {
+		static const http_status_lines TABLE;
 		char ver[4];
 		int16_t code = this->code;
 
+		/* fast path: HTTP/1.1 with the default phrase. (codes are in ascending order) */
+		if (_ver_major == 1 && _ver_minor == 1 && code >= 100) {
+			size_t low = 0, high = ALL_COUNT;
+
+			while (low < high) {
+				size_t mid = (low + high) / 2;
+
+				if (ALL[mid]._1 < code)
+					low = mid + 1;
+
+				else high = mid;
+			}
+
+			if (low < ALL_COUNT && ALL[low]._1 == code && phrase.size() == ALL[low]._len &&
+				!memcmp(phrase.c_str(), ALL[low]._2, ALL[low]._len))
+			{
+				const std::string& line = TABLE.lines[low];
+				out_string.append(line.c_str(), with_crlf ? line.size() : line.size() - 2);
+				return true;
+			}
+		}
+
 		ver[0] = _ver_major + '0'; ver[1] = '.';
 		ver[2] = _ver_minor + '0'; ver[3] = ' ';
 
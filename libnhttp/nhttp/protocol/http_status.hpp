@@ -162,6 +162,12 @@ namespace _ {
 		inline bool is_succeed() const { return code >= 200 && code < 300; }
 		inline bool is_failed() const { return !is_succeed(); }
 
+		/* reset to 200 OK in place. (the phrase keeps its capacity) */
+		inline void clear() {
+			_ver_major = _ver_minor = 1;
+			set_default_phrase(*this, code = 200);
+		}
+
 		/* set status code and its phrase. */
 		inline void set(int32_t code, const char* phrase = nullptr) {
 			if (!phrase)
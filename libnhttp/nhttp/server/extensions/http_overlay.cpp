@@ -43,13 +43,6 @@ namespace server {
 		if (predicate && !predicate(context, path_to))
 			return false;
 
-		std::shared_ptr<file_stream> stream
-			= std::make_shared<file_stream>(target_path.c_str(), "rb");
-
-		if (!stream->is_valid()) {
-			return false;
-		}
-
 		/* -- then generate http fundamental values... -- */
 		http_mime_type mime;
 
@@ -64,9 +57,13 @@ namespace server {
 		context->response = make_response(200);
 		http_vfile::generate_http_values(http_etag, http_mtime, path_to, file_mtime);
 
-		/* provide file. */
-		http_vfile::on_handle(context->request, context->response,
-			stream, file_size, file_mtime, http_etag, http_mtime, mime.stringify());
+		/* provide file: opened only if its content is sent. */
+		if (!http_vfile::on_handle(context->request, context->response,
+			target_path, file_size, file_mtime, http_etag, http_mtime, mime.stringify()))
+		{
+			context->response = make_response(200);
+			return false;
+		}
 
 		context->close();
 		return true;
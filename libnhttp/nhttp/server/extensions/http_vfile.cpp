@@ -66,25 +66,19 @@ namespace server {
             return true;
         }
 
-        std::shared_ptr<file_stream> stream
-            = std::make_shared<file_stream>(path_to.c_str(), "rb");
-
-        if (!stream->is_valid()) {
-            context->response->status.set(403);
-            context->close();
-            return true;
+        /* the file is opened only if its content is sent. */
+        if (!on_handle(context->request, context->response,
+            path_to, file_size, file_mtime, http_etag, http_mtime, mime_type))
+        {
+            context->response = make_response(403);
         }
 
-        context->response = make_response(200);
-        on_handle(context->request, context->response,
-            stream, file_size, file_mtime, http_etag, http_mtime, mime_type);
-
         context->close();
         return true;
     }
 
-    void http_vfile::on_handle(http_request_ptr& request, http_response_ptr& response,
-        const std::shared_ptr<stream>& stream, ssize_t file_size, time_t file_mtime,
+    bool http_vfile::on_handle(http_request_ptr& request, http_response_ptr& response,
+        const std::string& path_to, ssize_t file_size, time_t file_mtime,
         const std::string& http_etag, const std::string& http_mtime, const std::string& mime_type)
     {
         time_t c_mtime = 0; // --> client side modified time.
@@ -100,7 +94,7 @@ namespace server {
             if (!http_mime_type::try_parse(mime_type, content_type->get_value())) {
                 if (mime_type == http_mime_type::MULTIPART_BYTERANGES) {
                     response->status.set(400);
-                    return;
+                    return true;
                 }
             }
         }
@@ -123,7 +117,7 @@ namespace server {
         /* test If-Match header. */
         if (if_match && strnicmp(if_match, http_etag.c_str(), http_etag.size())) {
             response->status.set(412); // 412 Precondition Failed.
-            return;
+            return true;
         }
 
         /* parse If-Modified-Since header. */
@@ -139,7 +133,7 @@ namespace server {
             (if_modified_since && c_mtime <= file_mtime))
         {
             response->status.set(304); // 304 Not Modified.
-            return;
+            return true;
         }
 
         /* check range request's E-Tag. */
@@ -160,7 +154,7 @@ namespace server {
         /* if request is by HEAD method, send no content. */
         if (request->get_target().get_method() == http_method::HEAD) {
             response_headers.set(http_header::CONTENT_LENGTH, std::to_string(file_size));
-            return;
+            return true;
         }
 
         if (request_headers.isset(http_header::RANGE)) {
@@ -169,7 +163,7 @@ namespace server {
 
             if (!key_e) {
                 response->status.set(416); // 416 Requested Range Not Satisfied.
-                return;
+                return true;
             }
 
             const char* key_s = ltrim(range.c_str(), range.size());
@@ -180,12 +174,12 @@ namespace server {
 
             if (!sep_m || strnicmp(key_s, "bytes", size_t(key_e - key_s))) {
                 response->status.set(416); // 416 Requested Range Not Satisfied.
-                return;
+                return true;
             }
 
             const char* val_m = ltrim(sep_m + 1, size_t(val_e - sep_m - 1));
 
-            ssize_t stream_size = stream->get_length();
+            ssize_t stream_size = file_size;
             ssize_t range_begin = to_int64(val_s, 10, size_t(sep_m - val_s));
             ssize_t range_end = 0;
 
@@ -202,7 +196,7 @@ namespace server {
                 range_begin > stream_size || range_end > stream_size)
             {
                 response->status.set(416); // 416 Requested Range Not Satisfied.
-                return;
+                return true;
             }
 
             std::string range_is = "bytes ";
@@ -213,17 +207,29 @@ namespace server {
             range_is.push_back('/');
             range_is.append(std::to_string(stream_size));
 
+            std::shared_ptr<file_stream> stream
+                = std::make_shared<file_stream>(path_to.c_str(), "rb");
+
+            if (!stream->is_valid())
+                return false;
+
             response_headers.set(http_header::CONTENT_RANGE, range_is);
             response_headers.set(http_header::CONTENT_TYPE, mime_type);
 
             response->status.set(206); // 206 Partial Content.
             response->content = std::make_shared<range_stream>(stream, range_begin, range_end);
-            return;
+            return true;
         }
 
+        std::shared_ptr<file_stream> stream
+            = std::make_shared<file_stream>(path_to.c_str(), "rb");
+
+        if (!stream->is_valid())
+            return false;
+
         response_headers.set(http_header::CONTENT_TYPE, mime_type);
         response->content = stream;
-        return;
+        return true;
     }
 
 }
@@ -52,9 +52,13 @@ namespace server {
 		virtual bool on_handle(std::shared_ptr<http_context> context);
 
 	protected:
-		/* generates http response which support range and cache headers. */
-		static void on_handle(http_request_ptr& request, http_response_ptr& response, 
-			const std::shared_ptr<stream>& stream, ssize_t file_size, time_t file_mtime, 
+		/**
+		 * generates http response which support range and cache headers.
+		 * the file is opened only if its content is sent, not for HEAD, 304 and 412.
+		 * @returns false if the file couldn't be opened.
+		 */
+		static bool on_handle(http_request_ptr& request, http_response_ptr& response, 
+			const std::string& path_to, ssize_t file_size, time_t file_mtime, 
 			const std::string& http_etag, const std::string& http_mtime, const std::string& mime_type);
 	};
 
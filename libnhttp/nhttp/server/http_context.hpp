@@ -3,6 +3,8 @@
 #include "http_taggable.hpp"
 #include "../io/memory_stream.hpp"
 #include "../io/range_stream.hpp"
+#include "../io/push_stream.hpp"
+#include "../io/shared_buffer.hpp"
 #include "../protocol/http_mime_type.hpp"
 #include "../protocol/http_form_data.hpp"
 
@@ -109,9 +111,17 @@ namespace server {
 			}
 		}
 
+		/* takes the bytes of the string without copying them. */
+		http_response(std::string&& str, const http_mime_type& mime = http_mime_type::TEXT_HTML)
+			: http_response(shared_buffer::make(std::move(str)), mime) { }
+
 		http_response(const std::wstring& str, const http_mime_type& mime = http_mime_type::TEXT_HTML)
 			: http_response(wcs_to_mbs(str), mime) { }
 
+		/* shares the buffer with other responses, e.g. a hot static payload. */
+		http_response(const std::shared_ptr<const shared_buffer>& buffer, const http_mime_type& mime = http_mime_type::APPLICATION_OCTET)
+			: http_response(std::make_shared<shared_buffer_stream>(buffer), mime) { }
+
 		http_response(const std::shared_ptr<stream>& stream, size_t length, const http_mime_type& mime = http_mime_type::APPLICATION_OCTET)
 			: http_response(stream, 0, length, mime) { }
 
@@ -148,6 +158,7 @@ namespace server {
 	 */
 	class NHTTP_API http_context {
 		friend class http_listener;
+		friend class drivers::http_default_driver;
 
 	private:
 		std::shared_ptr<http_raw_context> raw;
@@ -169,6 +180,32 @@ namespace server {
 		std::shared_ptr<http_link> link;
 		std::shared_ptr<http_taggable> global;
 
+	private:
+		/* determines nobody refers request and response except this. */
+		inline bool is_recyclable() const {
+			return request.use_count() == 1 && response.use_count() <= 1;
+		}
+
+		/* reset the context to reuse it for next request on same link. */
+		inline void recycle() {
+			_is_closed = false;
+
+			request->clear_tags();
+			request->forms.clear();
+
+			if (!response)
+				response = std::make_shared<http_response>(200);
+
+			else {
+				response->status.clear();
+				response->headers.vec.clear();
+				response->content = nullptr;
+			}
+
+			link = raw->link;
+			global = nullptr;
+		}
+
 	public:
 		/* determines this context has closed or not. */
 		inline bool is_closed() const {
@@ -24,8 +24,24 @@ namespace server {
 		hal::spinlock_t spinlock;
 		std::shared_ptr<http_link_driver> driver;
 
+		/* link of the connection if this is a scope for a pipelined request. */
+		std::shared_ptr<http_link> parent;
+
+		/* addresses of the connection, captured once when the link initiated. */
+		std::string local_addr, remote_addr;
+		int32_t local_port = 0;
+		bool ipv6 = false;
+
 	public:
-		inline bool is_alive() const { return _is_alive; }
+		inline bool is_alive() const { return parent ? parent->is_alive() : _is_alive.load(); }
+
+		/* get local and remote addresses without asking the socket. */
+		inline const std::string& get_local_addr() const { return parent ? parent->local_addr : local_addr; }
+		inline const std::string& get_remote_addr() const { return parent ? parent->remote_addr : remote_addr; }
+
+		/* get local port number and determines the connection is IPv6 or not. */
+		inline int32_t get_local_port() const { return parent ? parent->local_port : local_port; }
+		inline bool is_ipv6() const { return parent ? parent->ipv6 : ipv6; }
 
 		/**
 		 * replace link driver once.
@@ -77,6 +93,17 @@ namespace server {
 		/* event handler. */
 		virtual bool on_event() { return false; }
 
+		/**
+		 * make a link which has its own tags, for a request handled concurrently.
+		 * (extensions keep their states as tags of the link)
+		 */
+		inline std::shared_ptr<http_link> make_scoped_link() const {
+			auto scoped = std::make_shared<http_link>();
+
+			scoped->parent = link;
+			return scoped;
+		}
+
 		/**
 		 * replace driver if required.
 		 * (this method shouldn't be called if replacement disallowed)
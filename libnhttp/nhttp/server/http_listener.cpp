@@ -80,7 +80,13 @@ namespace server {
 	}
 
 	bool http_listener::on_newbie(std::shared_ptr<http_context>& out, const std::shared_ptr<http_raw_context>& context) {
-		return (out = std::make_shared<http_context>(context)) != nullptr;
+		/* the driver keeps the facade only if it can be recycled. */
+		if (auto& facade = context->facade) {
+			facade->recycle();
+			return (out = facade) != nullptr;
+		}
+
+		return (out = context->facade = std::make_shared<http_context>(context)) != nullptr;
 	}
 
 	void http_listener::on_handle(const std::shared_ptr<http_context>& context) {
@@ -14,15 +14,64 @@ namespace server {
 		/* request timeout in second. */
 		int32_t timeout = 5;
 
+		/**
+		 * maximum requests parsed ahead while a response is pending. 0 for disable.
+		 * @note: requests with content are never handled ahead.
+		 */
+		int32_t pipeline_depth = 8;
+
+		/**
+		 * limits of a request, 0 for unlimited.
+		 * @note: requests over limits are answered without handlers, then the connection is closed.
+		 */
+		struct {
+			/* request line in bytes. (414 URI Too Long) */
+			size_t request_line = 8192;
+
+			/* count of request headers. (431 Request Header Fields Too Large) */
+			size_t header_count = 100;
+
+			/* each header line in bytes. (431) */
+			size_t header_size = 8192;
+
+			/* request line and headers in bytes, 0 for two protocol buffers. (431) */
+			size_t header_bytes = 0;
+
+			/* request content in bytes. (413 Payload Too Large, chunked content is cut off) */
+			int64_t content_length = 0;
+		} limits;
+
 		/* protocol buffer size in kbytes. */
 		size_t buffer_size_in_kb = 8;
 
+		/**
+		 * block size in kbytes to read blocking content on workers.
+		 * the next block is read ahead while the current one is being sent.
+		 * 0 for half of a protocol buffer.
+		 */
+		size_t read_ahead_in_kb = 32;
+
+		/**
+		 * maximum bytes in kbytes to read and send content at once.
+		 * starts from half of a protocol buffer, grows while the send buffer has room,
+		 * and shrinks again for slow clients. 0 for fixed size.
+		 */
+		size_t send_chunk_max_in_kb = 256;
+
 		/**
 		 * maximum total protocol buffers in count.
-		 * @note: listener will pre-allocate buffers.
+		 * @note: buffers are allocated on demand unless `buffers.preallocate` set.
 		 */
 		size_t max_total_buffers = 2048;
 
+		struct {
+			/* reserve all protocol buffers in one region at startup. */
+			int8_t preallocate = 0;
+
+			/* try huge pages for the reserved region, normal pages if unavailable. */
+			int8_t huge_pages = 1;
+		} buffers;
+
 		struct {
 			/* enable expose `Server` header or not. */
 			int8_t enable = 1;
@@ -13,6 +13,8 @@ namespace server {
 
 	class http_link;
 	class http_raw_link;
+	class http_context;
+	class http_listener;
 	
 namespace drivers {
 	class http_default_driver;
@@ -50,6 +52,7 @@ namespace drivers {
 	 */
 	class NHTTP_API http_raw_context {
 		friend class http_raw_link;
+		friend class http_listener;
 		friend class drivers::http_default_driver;
 
 	public:
@@ -59,27 +62,55 @@ namespace drivers {
 		std::string					remote_addr;
 		http_raw_request			request;
 		http_raw_response			response;
-		bool						is_closed;
-		bool						is_quiet;
+		bool						is_closed		= false;
+		bool						is_quiet		= false;
 		std::shared_ptr<http_link>	link;
 		
 	private:
 		hal::spinlock_safe_t			spinlock;
-		drivers::http_default_driver*	driver;
-		bool							keepalive;
-		void(* _close)(http_raw_context&);
+		drivers::http_default_driver*	driver			= nullptr;
+		bool							keepalive		= false;
+		void(* _close)(http_raw_context&)				= nullptr;
+
+		/* facade context cached by http_listener to reuse it. */
+		std::shared_ptr<http_context>	facade;
 
 	protected:
 		inline bool is_keepalive() const { return keepalive; }
 
+		/**
+		 * reset the context to reuse it for next request.
+		 * (strings and containers keep their capacity)
+		 */
+		inline void reset() {
+			port = 0;
+			hostname.clear();
+			local_addr.clear();
+			remote_addr.clear();
+
+			request.timestamp = 0;
+			request.target.clear();
+			request.headers.vec.clear();
+			request.queries.clear();
+			request.content = nullptr;
+
+			response.status.clear();
+			response.headers.vec.clear();
+			response.content = nullptr;
+
+			is_closed = is_quiet = keepalive = false;
+		}
+
 		/**
 		 * configure raw_link to context.
+		 * @returns true if the context has been closed already.
 		 */
-		inline void configure(drivers::http_default_driver* driver, void(* _close)(http_raw_context&)) {
+		inline bool configure(drivers::http_default_driver* driver, void(* _close)(http_raw_context&)) {
 			std::lock_guard<decltype(spinlock)> guard(spinlock);
 			this->driver = driver;
 			this->_close = _close;
 			is_quiet = false;
+			return is_closed;
 		}
 
 		/**
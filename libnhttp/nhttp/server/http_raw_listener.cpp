@@ -11,20 +11,17 @@ namespace server {
 		: base::listener_base(watcher, params.worker_count), params(params)
 	{
 		chunk_alloc = std::make_shared<http_chunked_alloc>(
-			params.max_total_buffers, params.buffer_size_in_kb * 1024);
+			params.max_total_buffers, params.buffer_size_in_kb * 1024,
+			params.buffers.preallocate != 0, params.buffers.huge_pages != 0);
 	}
 
 	base::session_base* http_raw_listener::on_enter() {
-		if (http_chunked_bytes* chunk = chunk_alloc->alloc()) {
-			auto buffer = std::make_shared<http_chunked_buffer>(chunk_alloc, chunk);
-			return new http_raw_link(this, buffer);
-		}
-
-		return nullptr;
+		/* chunks are acquired when the first bytes arrive. */
+		return http_raw_link::create(this, chunk_alloc);
 	}
 
 	void http_raw_listener::on_leave(base::session_base* link) {
-		delete link;
+		http_raw_link::destroy(static_cast<http_raw_link*>(link));
 	}
 
 }
@@ -83,6 +83,21 @@ namespace _ {
 			tags.clear();
 		}
 
+	protected:
+		/* destroy all tags. */
+		inline void clear_tags() {
+			lock.lock_write();
+
+			for (auto& each : tags) {
+				each.second.dtor(each.second.data);
+			}
+
+			tags.clear();
+			hooks.clear();
+
+			lock.unlock_write();
+		}
+
 	public:
 		/**
 		 * get tag object pointer.
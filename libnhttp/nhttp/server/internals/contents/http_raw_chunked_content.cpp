@@ -18,38 +18,54 @@ namespace server {
 
 
 	void http_raw_chunked_content_handler::on_initiate() {
-		state.cont_mark = buffer->get_size();
 		state.found_lf = -1;
 	}
 
 	void http_raw_chunked_content_handler::on_finalize() {
+		/* wake up the handler if the link lost before the end. */
+		if (feed)
+			feed->finish();
 	}
 
 	int32_t http_raw_chunked_content_handler::on_event(socket_t& socket) {
 		size_t avail = buffer->get_left_capacity();
 		size_t chunk = buffer->get_chunk_size();
 
-		if (!skip_all && !feed->wanna_read())
+		/* the handler closed the content stream: waste rest bytes. */
+		if (feed && feed->is_disconnected()) {
+			feed = nullptr;
+			skip_all = true;
+		}
+
+		/* nobody reads content which isn't sent yet: the link will be closed. */
+		if (skip_all && expect_continue)
+			return EVENT_SUCCESS;
+
+		if (feed && !feed->wanna_read())
 			return EVENT_AGAIN;
 
+		/* the handler started reading: let the client send content. */
+		if (expect_continue) {
+			int32_t ret = send_continue(socket);
+
+			if (ret <= 0)
+				return ret < 0 ? EVENT_FAILURE : EVENT_AGAIN;
+		}
+
 		if (!buffer->get_size())
 			state.read_more = 1;
 
 		if (state.read_more && avail <= (chunk >> 2)) {
-			size_t size = buffer->get_size();
-
 			/**
 			 * if buffered length is longer than 2 * chunk,
-			 * wait until buffered bytes being read.
+			 * stop receiving until content bytes moved to the ring.
 			 */
-			if (size >= (chunk << 1)) {
+			if (buffer->get_size() >= (chunk << 1))
 				state.read_more = 0;
-				return EVENT_AGAIN;
-			}
 
 			/* try preallocate more chunks. */
-			if (!buffer->preallocate() && !avail)
-				return EVENT_AGAIN;
+			else if (buffer->preallocate())
+				avail = buffer->get_left_capacity();
 		}
 
 		while (avail && state.read_more) {
@@ -71,45 +87,8 @@ namespace server {
 				return EVENT_FAILURE;
 			}
 
-			//if (state.cont_phase == CONP_HEADER ||
-			//	state.cont_phase == CONP_BODY_END)
-			//{
-			//	if (state.found_lf < 0) {
-			//		/* find LF from live buffer. */
-			//		if (void* t = memchr(live_buf, '\n', read)) {
-			//			size_t offset = size_t((uint8_t*)t - live_buf);
-			//			state.found_lf = ssize_t(buffer->get_size() + offset);
-			//		}
-			//	}
-			//}
-
-			/* skip bytes instead of pushing live_buf into buffer. */
-			if (skip_all && state.cont_left) {
-				size_t wastes = size_t(read) > state.cont_left ?
-								size_t(state.cont_left) : read;
-
-				state.cont_read += wastes;
-				state.cont_mark -= wastes;
-
-				if (!(state.cont_left -= wastes))
-					state.read_more = 0;
-
-				/* if reading content section and in skipping mode, waste all content bytes. */
-				if (read - wastes > 0) {
-					size_t len = buffer->write(live_buf + wastes, read - wastes);
-
-					avail -= len;
-					state.cont_mark += len;
-				}
-			}
-
-			else {
-				/* push live buf to buffer. */
-				size_t len = buffer->write(live_buf, read);
-
-				avail -= len;
-				state.cont_mark += len;
-			}
+			/* push live buf to buffer. */
+			avail -= buffer->write(live_buf, read);
 		}
 
 		/**
@@ -120,7 +99,7 @@ namespace server {
 		 *  0\r\n
 		 *  \r\n
 		 */
-		while (state.cont_mark > 0) {
+		while (buffer->get_size() > 0) {
 			if (state.cont_phase == CONP_HEADER) {
 				if (state.found_lf < 0) {
 					state.found_lf = buffer->find('\n');
@@ -136,45 +115,58 @@ namespace server {
 					line_buf.resize(state.found_lf + 1);
 
 				buffer->read(&line_buf[0], state.found_lf + 1);
-				state.cont_mark -= state.found_lf + 1;
 
 				/* handle chunk body. */
 				state.cont_phase = CONP_BODY;
 				state.cont_left = to_int64(&line_buf[0], 16, state.found_lf + 1);
 				state.cont_read = 0;
+
+				/* content is too large: cut it off rather than buffering it. */
+				if (limit && (state.cont_total += state.cont_left) > uint64_t(limit)) {
+					if (feed) {
+						feed->close();
+						feed = nullptr;
+					}
+
+					return EVENT_FAILURE;
+				}
 			}
 
 			if (state.cont_phase == CONP_BODY) {
-				if (state.cont_left && state.cont_mark) {
-					bool is_last_notify = state.cont_mark >= ssize_t(state.cont_left);
-					size_t cont_bytes = is_last_notify ? state.cont_left : state.cont_mark;
+				/* move chunk bytes to the ring, or waste them if skipping. */
+				while (state.cont_left && buffer->get_size()) {
+					size_t span = buffer->get_size(), moved;
 
-					state.cont_left -= cont_bytes;
-					state.cont_read += cont_bytes;
-					state.cont_mark -= cont_bytes;
+					if (span > state.cont_left)
+						span = size_t(state.cont_left);
 
-					if (cont_bytes) {
-						if (feed) {
-							state.cont_notf += cont_bytes;
-							feed->notify(cont_bytes, false);
-						}
+					if (feed) {
+						uint8_t* dest = feed->reserve_feed(span);
 
-						else buffer->skip(cont_bytes);
+						/* the ring is full: wait until the handler reads. */
+						if (!dest)
+							break;
+
+						feed->commit_feed(moved = buffer->read(dest, span));
 					}
-				}
 
-				if (state.cont_left <= 0) {
-					state.cont_phase = CONP_BODY_END;
-					state.found_lf = -1;
+					else moved = buffer->skip(span);
+
+					if (!moved)
+						break;
+
+					state.cont_left -= moved;
+					state.cont_read += moved;
 				}
 
-				else break;
+				if (state.cont_left > 0)
+					break;
+
+				state.cont_phase = CONP_BODY_END;
+				state.found_lf = -1;
 			}
 
 			if (state.cont_phase == CONP_BODY_END) {
-				if ((skip_all && state.cont_left) || (feed && !feed->is_empty()))
-					break;
-
 				if (state.found_lf < 0) {
 					state.found_lf = buffer->find('\n');
 
@@ -191,12 +183,10 @@ namespace server {
 					line_buf.resize(state.found_lf + 1);
 
 				buffer->read(&line_buf[0], state.found_lf + 1);
-				state.cont_mark -= state.found_lf + 1;
 
 				if (state.cont_read <= 0) {
-					if (feed) {
-						feed->notify(0, true);
-					}
+					if (feed)
+						feed->finish();
 
 					state.cont_end = 1;
 					return EVENT_SUCCESS;
@@ -10,6 +10,9 @@ namespace server {
 	public:
 		std::vector<char> line_buf;
 
+		/* maximum bytes of content, 0 for unlimited. */
+		int64_t limit = 0;
+
 		struct {
 			int8_t read_more : 1;
 			int8_t cont_phase : 3; /* 0: header, 1: body, 2: body-end */
@@ -18,8 +21,7 @@ namespace server {
 
 			uint64_t cont_left;
 			uint64_t cont_read;
-			uint64_t cont_notf;
-			int64_t cont_mark;
+			uint64_t cont_total;
 		} state = { 0, };
 
 	public:
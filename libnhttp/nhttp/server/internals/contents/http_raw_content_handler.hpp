@@ -30,9 +30,40 @@ namespace server {
 	public:
 		bool skip_all;
 
+		/* the client waits `100 Continue` until the handler reads content. */
+		bool expect_continue;
+		size_t continue_sent;
+
 		std::shared_ptr<http_chunked_buffer> buffer;
 		std::shared_ptr<http_raw_request_content> feed;
 
+	public:
+		http_raw_content_handler() : skip_all(false), expect_continue(false), continue_sent(0) { }
+		virtual ~http_raw_content_handler() { }
+
+	protected:
+		/**
+		 * send `100 Continue` interim response.
+		 * @returns 1 if sent, 0 if the socket is busy, -1 on failure.
+		 */
+		inline int32_t send_continue(socket_t& socket) {
+			static const char CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+
+			while (continue_sent < sizeof(CONTINUE) - 1) {
+				ssize_t sent = socket.write(CONTINUE + continue_sent, sizeof(CONTINUE) - 1 - continue_sent);
+
+				if (sent <= 0) {
+					int32_t err = socket.get_errno();
+					return err == EINTR || err == EAGAIN || err == EWOULDBLOCK ? 0 : -1;
+				}
+
+				continue_sent += size_t(sent);
+			}
+
+			expect_continue = false;
+			return 1;
+		}
+
 	public:
 		/* initiate content handler. */
 		virtual void on_initiate() = 0;
@@ -16,112 +16,106 @@ namespace server {
 	};
 
 	void http_raw_fixed_len_content_handler::on_initiate() {
-		state.cont_mark = buffer->get_size();
 	}
 
 	void http_raw_fixed_len_content_handler::on_finalize() {
+		/* wake up the handler if the link lost before the end. */
+		if (feed)
+			feed->finish();
 	}
 
 	int32_t http_raw_fixed_len_content_handler::on_event(socket_t& socket) {
-		size_t avail = buffer->get_left_capacity();
-		size_t chunk = buffer->get_chunk_size();
+		/* the handler closed the content stream: waste rest bytes. */
+		if (feed && feed->is_disconnected()) {
+			feed = nullptr;
+			skip_all = true;
+		}
+
+		/* nobody reads content which isn't sent yet: the link will be closed. */
+		if (skip_all && expect_continue)
+			return EVENT_SUCCESS;
 
 		if (feed && !feed->wanna_read())
 			return EVENT_AGAIN;
 
-		if (!buffer->get_size())
-			state.read_more = 1;
-
-		if (state.read_more && avail <= (chunk >> 2)) {
-			size_t size = buffer->get_size();
+		/* the handler started reading: let the client send content. */
+		if (expect_continue) {
+			int32_t ret = send_continue(socket);
 
-			/**
-			 * if buffered length is longer than 2 * chunk,
-			 * wait until buffered bytes being read.
-			 */
-			if (size >= (chunk << 1)) {
-				state.read_more = 0;
-				return EVENT_AGAIN;
-			}
-
-			/* try preallocate more chunks. */
-			if (!buffer->preallocate() && !avail)
-				return EVENT_AGAIN;
+			if (ret <= 0)
+				return ret < 0 ? EVENT_FAILURE : EVENT_AGAIN;
 		}
 
-		while (avail && state.read_more) {
-			uint8_t live_buf[2048];
-			size_t slice = avail > sizeof(live_buf) ? sizeof(live_buf) : avail;
-			ssize_t read = socket.read(live_buf, slice);
+		/* content bytes that were received with the request header. */
+		while (state.cont_left && buffer->get_size()) {
+			size_t span = size_t(state.cont_left), moved;
 
-			if (read <= 0) {
-				int32_t err = socket.get_errno();
+			if (span > buffer->get_size())
+				span = buffer->get_size();
 
-				if (err == EINTR)
-					continue;
+			if (feed) {
+				uint8_t* dest = feed->reserve_feed(span);
 
-				if (err == EAGAIN || err == EWOULDBLOCK) {
-					state.read_more = 0;
-					break;
-				}
+				/* the ring is full: wait until the handler reads. */
+				if (!dest)
+					return EVENT_AGAIN;
 
-				return EVENT_FAILURE;
+				feed->commit_feed(moved = buffer->read(dest, span));
 			}
 
-			/* skip bytes instead of pushing live_buf into buffer. */
-			if (skip_all && state.cont_left) {
-				size_t wastes = read > state.cont_left ?
-								size_t(state.cont_left) : read;
+			else moved = buffer->skip(span);
 
-				state.cont_read += wastes;
-				state.cont_mark -= wastes;
+			if (!moved)
+				break;
 
-				if (!(state.cont_left -= wastes))
-					state.read_more = 0;
+			state.cont_left -= moved;
+			state.cont_read += moved;
+		}
 
-				/* if reading content section and in skipping mode, waste all content bytes. */
-				if (read - wastes > 0) {
-					size_t len = buffer->write(live_buf + wastes, read - wastes);
+		/* then receive rest bytes into the ring directly. */
+		while (state.cont_left > 0 && !buffer->get_size()) {
+			uint8_t live_buf[2048];
+			uint8_t* dest = live_buf;
+			size_t slice = sizeof(live_buf);
 
-					avail -= len;
-					state.cont_mark += len;
-				}
+			if (feed) {
+				slice = size_t(state.cont_left);
+
+				if (!(dest = feed->reserve_feed(slice)))
+					return EVENT_AGAIN;
 			}
 
-			else {
-				/* push live buf to buffer. */
-				size_t len = buffer->write(live_buf, read);
+			else if (slice > size_t(state.cont_left))
+				slice = size_t(state.cont_left);
 
-				avail -= len;
-				state.cont_mark += len;
-			}
-		}
+			ssize_t read = socket.read(dest, slice);
 
-		if (state.cont_left && state.cont_mark) {
-			bool is_last_notify = state.cont_mark >= state.cont_left;
-			size_t cont_bytes = is_last_notify ? size_t(state.cont_left) : state.cont_mark;
+			if (read <= 0) {
+				int32_t err = socket.get_errno();
 
-			state.cont_left -= cont_bytes;
-			state.cont_read += cont_bytes;
-			//received_bytes -= cont_bytes;
+				if (err == EINTR)
+					continue;
 
-			if (cont_bytes) {
-				if (feed) {
-					feed->notify(cont_bytes, is_last_notify);
-				}
+				if (err == EAGAIN || err == EWOULDBLOCK)
+					return EVENT_AGAIN;
 
-				else buffer->skip(cont_bytes);
+				return EVENT_FAILURE;
 			}
 
-			/* marks cont_bytes as read. */
-			state.cont_mark -= cont_bytes;
-		}
+			if (feed)
+				feed->commit_feed(size_t(read));
 
-		if (state.cont_left <= 0) {
-			return EVENT_SUCCESS;
+			state.cont_left -= read;
+			state.cont_read += read;
 		}
 
-		return EVENT_AGAIN;
+		if (state.cont_left > 0)
+			return EVENT_AGAIN;
+
+		if (feed)
+			feed->finish();
+
+		return EVENT_SUCCESS;
 	}
 
 }
@@ -13,11 +13,8 @@ namespace server {
 	{
 	public:
 		struct {
-			int8_t read_more : 1;
-			
 			int64_t cont_left;
 			int64_t cont_read;
-			int64_t cont_mark;
 		} state = { 0, };
 
 	public:
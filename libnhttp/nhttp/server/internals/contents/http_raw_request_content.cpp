@@ -1,85 +1,49 @@
 #include "http_raw_request_content.hpp"
-#include "../http_chunked_buffer.hpp"
 
 namespace nhttp {
 namespace server {
 
-	http_raw_request_content::http_raw_request_content(std::shared_ptr<http_chunked_buffer> buffer, ssize_t total_bytes)
-		: waiter(false, true), buffer(buffer), total_bytes(total_bytes), read_requested(false),
-		  avail_bytes(0), is_end(false), non_block(false)
+	http_raw_request_content::http_raw_request_content(size_t capacity, ssize_t total_bytes)
+		: ring(capacity), total_bytes(total_bytes), read_requested(false),
+		  disconnected(false), non_block(false)
 	{
 	}
 
 	/* determines validity of this stream. */
 
 	bool http_raw_request_content::is_valid() const {
-		std::lock_guard<decltype(spinlock)> guard(spinlock);
-		return buffer != nullptr;
+		return !is_disconnected();
 	}
 
 	/* determines currently at end of stream. */
 
 	bool http_raw_request_content::is_end_of() const {
-		std::lock_guard<decltype(spinlock)> guard(spinlock);
-		return buffer == nullptr || (avail_bytes <= 0 && is_end) || !total_bytes;
+		return is_disconnected() || (ring.is_closed() && !ring.get_size()) || !total_bytes;
 	}
 
 	/* determines this stream is based on non-blocking or not. */
 
 	bool http_raw_request_content::is_nonblock() const {
-		std::lock_guard<decltype(spinlock)> guard(spinlock);
-		return buffer == nullptr || non_block;
+		return is_disconnected() || non_block.load(std::memory_order_relaxed);
 	}
 
 	bool http_raw_request_content::set_nonblock(bool value) {
-		std::lock_guard<decltype(spinlock)> guard(spinlock);
-		non_block = value;
+		non_block.store(value, std::memory_order_relaxed);
 		return true;
 	}
 
 	/* determines this stream can be read immediately or not. */
 
 	bool http_raw_request_content::can_read() const {
-		std::lock_guard<decltype(spinlock)> guard(spinlock);
-		return buffer == nullptr || avail_bytes > 0;
+		return is_disconnected() || ring.get_size() > 0 || ring.is_closed();
 	}
 
-	bool http_raw_request_content::wanna_read(size_t spins) const {
-		while (spins--) {
-			if (!spinlock.try_lock())
-				return false;
-
-			if (buffer != nullptr && read_requested) {
-				spinlock.unlock();
-				return true;
-			}
-
-			spinlock.unlock();
-		}
-
-		return false;
-	}
-
-	/* notify given bytes ready to provide. */
-
-	void http_raw_request_content::notify(size_t bytes, bool is_end) {
-		std::lock_guard<decltype(spinlock)> guard(spinlock);
-
-		avail_bytes += bytes;
-		this->is_end = is_end;
-
-		waiter.signal();
-	}
-
-	/* link will call this before terminating the request. */
+	/* handler will call this to stop receiving content. */
 
 	void http_raw_request_content::disconnect() {
-		std::lock_guard<decltype(spinlock)> guard(spinlock);
-
-		buffer = nullptr;
-		read_requested = false;
-		avail_bytes = 0;
-		waiter.signal();
+		disconnected.store(true, std::memory_order_release);
+		read_requested.store(false, std::memory_order_release);
+		ring.close();
 	}
 
 	/**
@@ -91,8 +55,7 @@ namespace server {
 	*/
 
 	ssize_t http_raw_request_content::get_length() const {
-		std::lock_guard<decltype(spinlock)> guard(spinlock);
-		if (buffer != nullptr) {
+		if (!is_disconnected()) {
 			set_errno_c(0);
 
 			if (total_bytes < 0)
@@ -116,50 +79,31 @@ namespace server {
 	*/
 
 	int32_t http_raw_request_content::read(void* buf, size_t len) {
-		std::lock_guard<decltype(spinlock)> guard(spinlock);
-		return read_locked(buf, len);
-	}
-
-	int32_t http_raw_request_content::read_locked(void* buf, size_t len) {
-		size_t read_bytes;
 		set_errno(0);
 
-		while (buffer != nullptr) {
-			if ((read_bytes = len > avail_bytes ? avail_bytes : len) > 0) {
-				size_t ret = buffer->read(buf, read_bytes);
-
-				/* keep flag if length is less than read. */
-				read_requested = ret < len;
-				avail_bytes -= ret;
+		if (len > INT32_MAX)
+			len = INT32_MAX;
 
-				if (avail_bytes > 0)
-					waiter.signal();
+		while (!is_disconnected()) {
+			size_t ret = ring.read(buf, len);
 
-				else waiter.unsignal();
-
-				std::this_thread::yield();
+			if (ret > 0)
 				return int32_t(ret);
-			}
 
-			read_requested = true;
+			/* the ring is drained and nothing will come anymore. */
+			if (ring.is_closed() && !ring.get_size())
+				break;
+
+			/* let the reactor start (or continue) receiving. */
+			if (!read_requested.load(std::memory_order_relaxed))
+				read_requested.store(true, std::memory_order_release);
 
-			if (non_block) {
+			if (non_block.load(std::memory_order_relaxed)) {
 				set_errno(EWOULDBLOCK);
-				spinlock.unlock();
 				return -1;
 			}
 
-			if (is_end) {
-				break;
-			}
-
-			spinlock.unlock();
-			std::this_thread::yield();
-
-			if (!waiter.try_wait())
-				 waiter.wait();
-
-			spinlock.lock();
+			ring.wait_readable();
 		}
 
 		set_errno(ENOENT);
@@ -1,11 +1,10 @@
 #pragma once
 #include "../../../io/stream.hpp"
-#include "../../../hal/event_t.hpp"
+#include "../../../hal/spsc_ring_t.hpp"
 
 namespace nhttp {
 namespace server {
 	class http_raw_link;
-	class http_chunked_buffer;
 	class http_raw_chunked_content_handler;
 	class http_raw_fixed_len_content_handler;
 	class http_raw_websocket_content_handler;
@@ -20,25 +19,19 @@ namespace server {
 		friend class http_raw_fixed_len_content_handler;
 		friend class http_raw_websocket_content_handler;
 
-	protected:
-		mutable hal::spinlock_t spinlock;
-
 	private:
-		mutable hal::event_lite_t waiter;
-		
+		/* reactor writes, handler reads. */
+		hal::spsc_ring_t ring;
 		ssize_t total_bytes;
-		size_t avail_bytes;
 
-		bool read_requested, is_end, non_block;
-		std::shared_ptr<http_chunked_buffer> buffer;
+		std::atomic<bool> read_requested, disconnected, non_block;
 		
 	public:
-		http_raw_request_content(std::shared_ptr<http_chunked_buffer> buffer, ssize_t total_bytes);
+		http_raw_request_content(size_t capacity, ssize_t total_bytes);
 
 	protected:
 		inline bool is_disconnected() const { 
-			std::lock_guard<decltype(spinlock)> guard(spinlock); 
-			return !buffer;
+			return disconnected.load(std::memory_order_acquire);
 		}
 
 	public:
@@ -63,28 +56,27 @@ namespace server {
 		virtual bool can_read() const override;
 
 	protected:
-		bool wanna_read(size_t spins = 5) const;
-
-		bool is_empty(size_t spins = 5) const {
-			while (spins--) {
-				if (!spinlock.try_lock())
-					return false;
+		/* determines the handler requested to read or not. */
+		inline bool wanna_read() const {
+			return read_requested.load(std::memory_order_acquire) && !is_disconnected();
+		}
 
-				if (buffer != nullptr && avail_bytes <= 0) {
-					spinlock.unlock();
-					return true;
-				}
+		/**
+		 * push content bytes into the ring.
+		 * @returns pushed bytes. (less than len if the ring is full)
+		 */
+		inline size_t push(const void* buf, size_t len) { return ring.write(buf, len); }
 
-				spinlock.unlock();
-			}
+		/* get contiguous span to receive content bytes directly. */
+		inline uint8_t* reserve_feed(size_t& len) { return ring.reserve(len); }
 
-			return false;
-		}
+		/* publish bytes received into the reserved span. */
+		inline void commit_feed(size_t len) { ring.commit(len); }
 
-		/* notify given bytes ready to provide. */
-		void notify(size_t bytes, bool is_end);
+		/* link will call this when all content bytes pushed or the link is lost. */
+		inline void finish() { ring.close(); }
 
-		/* link will call this before terminating the request. */
+		/* handler will call this to stop receiving content. */
 		void disconnect();
 
 	public:
@@ -144,22 +136,9 @@ namespace server {
 		}
 
 		/* close stream. */
-		virtual void close() {
+		virtual void close() override {
 			disconnect();
-			std::this_thread::yield();
 		}
-
-	protected:
-		/**
-		 * read bytes from stream with already locked.
-		 * @returns:
-		 *	> 0: read size.
-		 *  = 0: end of stream.
-		 *  < 0: not supported or not available if non-block.
-		 * @note:
-		 *	errno == EWOULDBLOCK: for non-block mode.
-		 */
-		virtual int32_t read_locked(void* buf, size_t len);
 	};
 
 }
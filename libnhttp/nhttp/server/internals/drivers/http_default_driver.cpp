@@ -8,6 +8,7 @@
 #include "../../../utils/path.hpp"
 #include "../../../io/stream.hpp"
 #include "../../http_raw_context.hpp"
+#include "../../http_context.hpp"
 #include "../../http_raw_listener.hpp"
 #include "../http_raw_link.hpp"
 
@@ -16,8 +17,21 @@ namespace server {
 namespace drivers {
 
 	http_default_driver::http_default_driver(http_raw_listener* listener, http_raw_link* raw_link)
-		: listener(listener), raw_link(raw_link), content_handler(nullptr), timestamp(0), state(NSESS_PREPARING), context_state(0)
+		: listener(listener), raw_link(raw_link), content_handler(nullptr), timestamp(0), tick(0), chunk_size(0), state(NSESS_PREPARING), context_state(0)
 	{
+		params = listener->get_params();
+
+		http_request_parser::limits_t limits;
+
+		limits.line = params.limits.request_line;
+		limits.header = params.limits.header_size;
+		limits.headers = params.limits.header_count;
+		limits.content = params.limits.content_length;
+
+		/* request line and headers can't exceed two chunks by default. */
+		limits.total = params.limits.header_bytes ? params.limits.header_bytes : params.buffer_size_in_kb << 11;
+		parser.set_limits(limits);
+
 		memset(&receives, 0, sizeof(receives));
 		memset(&contexts, 0, sizeof(contexts));
 		memset(&sends, 0, sizeof(sends));
@@ -31,7 +45,8 @@ namespace drivers {
 		http_link_driver::on_initiate(socket, asyncs, buffer, link);
 
 		state = NSESS_PREPARING;
-		timestamp = time(nullptr);
+		chunk_size = params.buffer_size_in_kb * 512;
+		touch();
 
 		/* reset state structures. */
 		reset_states();
@@ -49,38 +64,161 @@ namespace drivers {
 			current->unconfigure();
 		}
 
+		for (pipelined_t& each : pipeline)
+			each.context->unconfigure();
+
 		if (future_holder && !future_holder.is_completed()) {
 			future_holder.wait(-1);
 		}
 
+		/* break reference cycle between raw context and its facade. */
+		for (pipelined_t& each : pipeline) {
+			each.dispatch.wait(-1);
+			each.context->facade = nullptr;
+		}
+
+		for (auto* each : { &current, &ahead, &spare }) {
+			if (*each) {
+				(*each)->facade = nullptr;
+				*each = nullptr;
+			}
+		}
+
+		/* a writer pushing content stops waiting once nobody reads. */
+		content = spanned = nullptr;
+
+		pipeline.clear();
 		line_buf.clear();
-		current = nullptr;
+		ahead_buf.clear();
 
 		http_link_driver::on_finalize();
 	}
 	
+	void http_default_driver::on_closed(http_raw_context& context) {
+		++context.driver->context_state;
+		context.unconfigure();
+	}
+
+	void http_default_driver::on_closed_ahead(http_raw_context& context) {
+		/* checked when the context becomes current. */
+		context.unconfigure();
+	}
+
+	bool http_default_driver::is_recyclable(const std::shared_ptr<http_raw_context>& context) {
+		if (auto& facade = context->facade) {
+			/* the facade refers raw context twice: itself and its request. */
+			return context.use_count() == 3 && 
+				facade.use_count() == 1 && facade->is_recyclable();
+		}
+
+		return context.use_count() == 1;
+	}
+
+	size_t http_default_driver::get_feed_capacity(ssize_t length) const {
+		size_t capacity = buffer->get_chunk_size() << 1;
+
+		/* short content doesn't need a full-sized ring. */
+		if (length >= 0 && size_t(length) < capacity)
+			capacity = size_t(length);
+
+		return capacity;
+	}
+
+	std::shared_ptr<http_raw_context> http_default_driver::acquire_context() {
+		std::shared_ptr<http_raw_context> context = std::move(spare);
+
+		/* reuse previous context if nobody refers it. */
+		if (context && is_recyclable(context)) {
+			context->reset();
+			return context;
+		}
+
+		if (context)
+			context->facade = nullptr;
+
+		return std::make_shared<http_raw_context>();
+	}
+
+	void http_default_driver::retire_context(std::shared_ptr<http_raw_context>& context) {
+		if (spare)
+			spare->facade = nullptr;
+
+		spare = std::move(context);
+	}
+
+	void http_default_driver::prepare_context(http_raw_context& context, const http_request_parser::framing_t& framing) {
+		/* addresses are captured by the link once per connection. */
+		context.local_addr = link->get_local_addr();
+		context.remote_addr = link->get_remote_addr();
+		context.port = link->get_local_port();
+
+		/* qualify path name. */
+		context.request.target.set_path(
+			qualify_path(context.request.target.get_path()));
+
+		/**
+		 * remove port number from hostname.
+		 */
+		if (framing.host < 0)
+			context.hostname = context.local_addr;
+
+		else {
+			auto host = context.request.headers.vec.begin() + framing.host;
+			const char* hostname = host->get_value().c_str();
+			const char* seperator;
+			bool is_ipv6 = link->is_ipv6();
+
+			/* IPv6 connection. */
+			if (!is_ipv6)
+				seperator = (const char*)memchr(hostname, ':', host->get_value().size());
+			else seperator = (const char*)memchr(hostname, ']', host->get_value().size());
+
+			/* if `IP`:`PORT` notation, */
+			if (seperator) {
+				hostname = ltrim(hostname, size_t(seperator - hostname));
+
+				if (is_ipv6 && *hostname == '[')
+					++hostname;
+
+				if (hostname != seperator) {
+					http_header& header = const_cast<http_header&>(*host);
+					header.set_value(std::string(hostname, size_t(seperator - hostname)));
+				}
+			}
+		}
+
+		if (!context.hostname.size())
+			context.hostname = context.local_addr;
+
+		/* parse query-string. */
+		http_query_string::try_parse(
+			context.request.queries,
+			context.request.target.get_query_string());
+	}
+
 	bool http_default_driver::on_event() {
 		while (true) {
 			int32_t ret = EVENT_AGAIN;
 
 			switch (state) {
 			case NSESS_PREPARING:
-				current = std::make_shared<http_raw_context>();
+				retire_context(current);
+				current = acquire_context();
 
 				/* configure context. */
-				current->configure(this, [](http_raw_context& context) {
-					++context.driver->context_state;
-					context.unconfigure();
-				});
+				current->configure(this, on_closed);
 
 				current->link = link;
 				context_state = 0;
 
+				parser.begin(current->request.target, current->request.headers);
+
 				ret = EVENT_SUCCESS;
 				break;
 
 			case NSESS_RECEIVE_REQUEST:
-				if (socket.can_read())
+				/* buffered bytes can be parsed without new readiness. */
+				if (socket.can_read() || !receives.read_more)
 					ret = on_receive();
 
 				break;
@@ -103,11 +241,10 @@ namespace drivers {
 					content_handler = nullptr;
 				}
 
+				/* keep the context to recycle it at preparing. */
 				if (current) {
 					current->unconfigure();
 				}
-
-				current = nullptr;
 				
 				/* if line_buf is larger than half chunk, make it less than. */
 				if (line_buf.size() > params.buffer_size_in_kb * 512)
@@ -126,7 +263,23 @@ namespace drivers {
 					return true;
 				}
 
-				timestamp = time(nullptr);
+				/* requests parsed ahead are handled in order. */
+				if (pipeline.size() || ahead) {
+					ret = on_promote();
+					break;
+				}
+
+				/* nothing pipelined: return chunks and read-ahead blocks while idle. */
+				if (!buffer->get_size()) {
+					buffer->release();
+					std::vector<char>().swap(ahead_buf);
+
+					/* line buffer may be grown for large contents. */
+					if (line_buf.capacity() > params.buffer_size_in_kb * 512)
+						std::vector<char>(params.buffer_size_in_kb * 512).swap(line_buf);
+				}
+
+				touch();
 				reset_states();
 
 				ret = EVENT_SUCCESS;
@@ -151,223 +304,246 @@ namespace drivers {
 	
 	int32_t http_default_driver::on_receive() {
 		if (receives.has_done) {
-			current->request.timestamp = time(nullptr);
+			current->request.timestamp = hal::coarse_clock_t::realtime();
 			return EVENT_SUCCESS;
 		}
 
-		size_t avail = buffer->get_left_capacity();
+		/* parse bytes which are buffered already. (pipelined or left by content) */
+		while (buffer->get_size()) {
+			size_t len = 0, used = 0;
+			const uint8_t* span = buffer->peek_span(len);
+			int32_t ret = parser.parse(span, len, used);
 
-		if (avail > 0 && receives.read_more) {
-			uint8_t live_buf[2048];
-			size_t slice = avail > sizeof(live_buf) ? sizeof(live_buf) : avail;
-			ssize_t read = socket.read(live_buf, slice);
+			buffer->skip(used);
 
-			if (read <= 0) {
-				int32_t err = socket.get_errno();
+			if (ret != http_request_parser::PARSE_AGAIN)
+				return on_parsed(ret);
+		}
 
-				if (err == EINTR)
-					return EVENT_RETRY;
+		uint8_t live_buf[2048];
+		ssize_t read = socket.read(live_buf, sizeof(live_buf));
 
-				if (err == EAGAIN || err == EWOULDBLOCK) {
-					if (time(nullptr) - timestamp >= params.timeout) {
-						current->response.status.set(408); // 408 Request Timeout.
-						receives.has_error = 1;
-						return EVENT_SUCCESS;
-					}
-
-					return EVENT_AGAIN;
-				}
+		if (read <= 0) {
+			int32_t err = socket.get_errno();
 
-				return EVENT_FAILURE;
-			}
+			if (err == EINTR)
+				return EVENT_RETRY;
 
-			/* if no LF cached, */
-			if (receives.found_lf < 0) {
-				/* find LF from live buffer. */
-				if (void* t = memchr(live_buf, '\n', read)) {
-					size_t offset = size_t((uint8_t*)t - live_buf);
-					receives.found_lf = ssize_t(buffer->get_size() + offset);
+			if (err == EAGAIN || err == EWOULDBLOCK) {
+				if (hal::coarse_clock_t::monotonic() - tick >= int64_t(params.timeout) * 1000) {
+					current->response.status.set(408); // 408 Request Timeout.
+					receives.has_error = 1;
+					return EVENT_SUCCESS;
 				}
+
+				/* partial headers are kept by the parser: return chunks back to pool. */
+				buffer->release();
+				receives.read_more = 1;
+				return EVENT_AGAIN;
 			}
 
-			/* write to buffer. */
-			buffer->write(live_buf, read);
-			receives.read_more = 0;
+			return EVENT_FAILURE;
 		}
 
-		else if (receives.found_lf < 0) {
-			if (avail > 0) {
-				receives.read_more = 1;
-				return EVENT_RETRY;
-			}
+		/* parse live bytes directly, then keep the rest. (content or pipelined) */
+		size_t used = 0;
+		int32_t ret = parser.parse(live_buf, size_t(read), used);
+
+		if (used < size_t(read) && buffer->write(live_buf + used, size_t(read) - used) < size_t(read) - used)
+			return EVENT_FAILURE;
+
+		if (ret != http_request_parser::PARSE_AGAIN)
+			return on_parsed(ret);
+
+		return EVENT_RETRY;
+	}
 
-			/* protocol error: request headers are too large. */
-			current->response.status.set(431);
+	int32_t http_default_driver::on_parsed(int32_t ret) {
+		/* malformed request or too large headers. */
+		if (ret == http_request_parser::PARSE_ERROR) {
+			current->response.status.set(parser.get_status());
 			receives.has_error = 1;
 			return EVENT_SUCCESS;
 		}
 
-		/* more bytes required. */
-		if (receives.found_lf < 0)
-			return EVENT_AGAIN;
+		contexts.keep_alive = parser.framing.keep_alive;
 
-		if (!receives.has_target) {
-			size_t expected_size = receives.found_lf + 1;
+		/* content and upgraded protocol bytes aren't requests. */
+		contexts.pipelining = params.pipeline_depth > 0 &&
+			contexts.keep_alive && !parser.framing.upgrade;
 
-			if (line_buf.size() < expected_size)
-				line_buf.resize(expected_size);
+		receives.has_done = 1;
+		return EVENT_RETRY;
+	}
+
+	void http_default_driver::on_parse_ahead() {
+		while (pipeline.size() < size_t(params.pipeline_depth)) {
+			/* stop after a request which should be handled alone. */
+			if (pipeline.size() && (!pipeline.back().dispatched || !pipeline.back().keep_alive))
+				break;
 
-			buffer->read(&line_buf[0], expected_size);
+			if (!ahead) {
+				if (!buffer->get_size() && !socket.can_read())
+					break;
 
-			/* find next LF. */
-			receives.found_lf = buffer->find('\n');
+				ahead = acquire_context();
+				ahead->link = link;
 
-			/* malformed request ?*/
-			if (!http_resource::try_parse(current->request.target, &line_buf[0], expected_size)) {
-				current->response.status.set(400); // 400 Bad Request.
-				receives.has_error = 1;
-				return EVENT_SUCCESS;
+				parser.begin(ahead->request.target, ahead->request.headers);
 			}
 
-			receives.has_target = 1;
-			return EVENT_RETRY;
-		}
+			int32_t ret = http_request_parser::PARSE_AGAIN;
+			bool overflow = false;
 
-		else {
-			size_t expected_size = receives.found_lf + 1;
+			while (ret == http_request_parser::PARSE_AGAIN && buffer->get_size()) {
+				size_t len = 0, used = 0;
+				const uint8_t* span = buffer->peek_span(len);
 
-			if (line_buf.size() < expected_size)
-				line_buf.resize(expected_size);
+				ret = parser.parse(span, len, used);
+				buffer->skip(used);
+			}
 
-			buffer->read(&line_buf[0], expected_size);
+			/* errors and timeouts are handled when it becomes current. */
+			while (ret == http_request_parser::PARSE_AGAIN && socket.can_read()) {
+				uint8_t live_buf[2048];
+				ssize_t read = socket.read(live_buf, sizeof(live_buf));
+				size_t used = 0;
 
-			if (receives.found_lf == 0 ||
-				(receives.found_lf == 1 && line_buf[0] == '\r'))
-			{
-				receives.has_done = 1;
-				receives.found_lf = -1;
-				return EVENT_RETRY;
+				if (read <= 0)
+					break;
+
+				ret = parser.parse(live_buf, size_t(read), used);
+
+				if (used < size_t(read) && buffer->write(live_buf + used, size_t(read) - used) < size_t(read) - used) {
+					overflow = true;
+					break;
+				}
 			}
 
-			/* find next LF. */
-			http_header header_buf;
-			receives.found_lf = buffer->find('\n');
+			if (ret == http_request_parser::PARSE_AGAIN && !overflow)
+				break;
 
-			if (!http_header::try_parse(header_buf, &line_buf[0], expected_size)) {
-				current->response.status.set(400); // 400 Bad Request.
-				receives.has_error = 1;
-				return EVENT_SUCCESS;
+			pipelined_t& entry = pipeline.emplace_back();
+			const auto& framing = parser.framing;
+
+			entry.context = std::move(ahead);
+			entry.context->request.timestamp = hal::coarse_clock_t::realtime();
+			entry.context->configure(this, on_closed_ahead);
+
+			entry.dispatched = entry.has_error = 0;
+			entry.keep_alive = framing.keep_alive;
+			entry.pipelining = framing.keep_alive && !framing.upgrade;
+
+			if (overflow || ret == http_request_parser::PARSE_ERROR) {
+				/* no buffer to keep received bytes: 503 Service Unavailable. */
+				entry.context->response.status.set(overflow ? 503 : parser.get_status());
+				entry.has_error = 1;
+			}
+
+			/* requests with content are received when they become current. */
+			else if (!framing.chunked && framing.content_length < 0 && !framing.upgrade) {
+				auto context = entry.context;
+
+				entry.dispatched = 1;
+				context->link = make_scoped_link();
+
+				entry.dispatch = asyncs->future_of([this, context, framing]() {
+					prepare_context(*context, framing);
+					listener->on_raw_context(context, false);
+				});
 			}
+		}
+	}
 
-			current->request.headers.vec.push_back(std::move(header_buf));
+	int32_t http_default_driver::on_promote() {
+		retire_context(current);
+
+		touch();
+		reset_states();
+
+		/* continue receiving the request being parsed ahead. */
+		if (!pipeline.size()) {
+			current = std::move(ahead);
+			current->configure(this, on_closed);
+			context_state = 0;
+
+			state = NSESS_RECEIVE_REQUEST;
 			return EVENT_RETRY;
 		}
 
-		return EVENT_AGAIN;
+		pipelined_t& next = pipeline.front();
+
+		current = std::move(next.context);
+		future_holder = std::move(next.dispatch);
+
+		receives.has_done = 1;
+		receives.has_error = next.has_error;
+		contexts.keep_alive = next.keep_alive;
+		contexts.pipelining = next.pipelining && params.pipeline_depth > 0;
+		contexts.has_raised = next.dispatched;
+
+		/* the context may be closed before it becomes current. */
+		context_state = current->configure(this, on_closed) ? 1 : 0;
+		pipeline.erase(pipeline.begin());
+
+		state = NSESS_WAITING_CONTEXT;
+		return EVENT_RETRY;
 	}
 	
 	int32_t http_default_driver::on_handle() {
 		if (!contexts.has_raised) {
 			contexts.has_raised = 1;
 
-			future_holder = asyncs->future_of([this]() {
+			/* rejected while parsing: answer on the event loop without handlers. */
+			if (receives.has_error) {
+				contexts.rejected = 1;
+				return EVENT_SUCCESS;
+			}
+
+			/* the parser may go ahead while the context is being handled. */
+			auto framing = parser.framing;
+
+			future_holder = asyncs->future_of([this, framing]() {
 				/* if has error, no parse headers. */
 				if (!receives.has_error) {
-					/**
-					 * parse headers:
-					 * 1. content-length,
-					 * 2. transfer-encoding,
-					 */
-					auto host = current->request.headers.find_one(http_header::HOST);
-					auto content_length = current->request.headers.find_one(http_header::CONTENT_LENGTH);
-					auto transfer_encoding = current->request.headers.get(http_header::TRANSFER_ENCODING);
-					auto no_such_header = current->request.headers.vec.end();
 					const auto& method = current->request.target.get_method();
-
-					/* set remote address. */
-					current->local_addr = socket.get_local_addr();
-					current->remote_addr = socket.get_remote_addr();
-
-					union {
-						ipv6_addr _ipv6;
-						ipv4_addr _ipv4;
-					};
-
-					if (socket.get_local_addr(_ipv6))
-						current->port = int32_t(_ipv6.port);
-
-					else if (socket.get_local_addr(_ipv4))
-						current->port = int32_t(_ipv4.port);
-
-					/* qualify path name. */
-					current->request.target.set_path(
-						qualify_path(current->request.target.get_path()));
-
-					/**
-					 * remove port number from hostname.
-					 */
-					if (host == no_such_header)
-						current->hostname = current->local_addr;
-
-					else {
-						const char* hostname = host->get_value().c_str();
-						const char* seperator;
-						bool is_ipv6;
-						ipv6_addr temp;
-
-						/* IPv6 connection. */
-						if (!(is_ipv6 = socket.get_local_addr<ipv6_addr>(temp)))
-							seperator = (const char*)memchr(hostname, ':', host->get_value().size());
-						else seperator = (const char*)memchr(hostname, ']', host->get_value().size());
-
-						/* if `IP`:`PORT` notation, */
-						if (seperator) {
-							hostname = ltrim(hostname, size_t(seperator - hostname));
-
-							if (is_ipv6 && *hostname == '[')
-								++hostname;
-
-							if (hostname != seperator) {
-								http_header& header = const_cast<http_header&>(*host);
-								header.set_value(std::string(hostname, size_t(seperator - hostname)));
-							}
-						}
-					}
-
-					if (!current->hostname.size())
-						current->hostname = current->local_addr;
+					prepare_context(*current, framing);
 
 					/**
 					 * "Messages MUST NOT include both a Content-Length header field and a non-identity transfer-coding.
 					 * If the message does include a non-identity transfer-coding, the Content-Length MUST be ignored."
 					 * (RFC 2616, Section 4.4)
 					 */
-					if (!transfer_encoding || !strnicmp(transfer_encoding, "identity", 8)) {
-						if (content_length != no_such_header) {
+					if (framing.bad_coding) {
+						current->response.status.set(400);
+						receives.has_error = 1;
+					}
+
+					else if (!framing.chunked) {
+						if (framing.content_length >= 0) {
 							auto* handler = new http_raw_fixed_len_content_handler();
 
 							handler->buffer = buffer;
-							handler->feed = std::make_shared<http_raw_request_content>(buffer,
-								size_t(handler->state.cont_left = to_int64(content_length->get_value())));
+							handler->expect_continue = framing.expect_continue;
+							handler->state.cont_left = framing.content_length;
+							handler->feed = std::make_shared<http_raw_request_content>(
+								get_feed_capacity(handler->state.cont_left), handler->state.cont_left);
 
 							(content_handler = handler)->on_initiate();
 						}
 					}
 
-					else if (!strnicmp(transfer_encoding, "chunked", 7)) {
+					else {
 						auto* handler = new http_raw_chunked_content_handler();
 
 						handler->buffer = buffer;
-						handler->feed = std::make_shared<http_raw_request_content>(buffer, -1);
+						handler->expect_continue = framing.expect_continue;
+						handler->limit = params.limits.content_length;
+						handler->feed = std::make_shared<http_raw_request_content>(get_feed_capacity(-1), -1);
 
 						(content_handler = handler)->on_initiate();
 					}
 
-					else {
-						current->response.status.set(400);
-						receives.has_error = 1;
-					}
-
 					/* if GET, DELETE with request-content, make it to 400 Bad Request. */
 					if (content_handler) {
 						if (!method.is(NMETHOD_REQUEST_CONTENT)) {
@@ -384,25 +560,19 @@ namespace drivers {
 						}
 					}
 
-					/* parse query-string. */
-					http_query_string::try_parse(
-						current->request.queries,
-						current->request.target.get_query_string());
-
-					/* qualify path string. */
-					current->request.target.set_path(
-						qualify_path(current->request.target.get_path()));
 				}
 
 				listener->on_raw_context(current, receives.has_error);
 			});
-
-			receives.found_lf = -1;
 		}
 
 		if (future_holder && !future_holder.is_completed())
 			return EVENT_AGAIN;
 
+		/* parse next requests while the context is being handled. */
+		if (!content_handler && contexts.pipelining && !receives.has_error)
+			on_parse_ahead();
+
 		if (context_state) {
 			if (!content_handler) {
 				if (!future_holder.is_completed())
@@ -411,8 +581,12 @@ namespace drivers {
 				return EVENT_SUCCESS;
 			}
 
-			//contexts.cont_skip = 1;
-			content_handler->feed = nullptr;
+			/* the context has gone: wake up readers, then waste rest bytes. */
+			if (content_handler->feed) {
+				content_handler->feed->close();
+				content_handler->feed = nullptr;
+			}
+
 			content_handler->skip_all = true;
 		}
 
@@ -421,6 +595,12 @@ namespace drivers {
 			int32_t state = content_handler->on_event(socket);
 
 			if (state == EVENT_SUCCESS) {
+				/* content was never requested: the client may send it anytime, so close after. */
+				if (content_handler->expect_continue) {
+					contexts.keep_alive = 0;
+					contexts.pipelining = 0;
+				}
+
 				content_handler->on_finalize();
 				delete content_handler;
 
@@ -434,214 +614,415 @@ namespace drivers {
 		return EVENT_AGAIN;
 	}
 	
-	int32_t http_default_driver::on_send() {
-		/* generates response header bytes. */
-		if (!sends.buffer_state) {
-			future_holder = asyncs->future_of([this]() {
-				auto& status = current->response.status;
-				auto& headers = current->response.headers;
-				std::string live_buf;
-				size_t length = 0;
+	void http_default_driver::encode_head() {
+		auto& status = current->response.status;
+		auto& headers = current->response.headers;
+		ssize_t length = 0;
 
-				/* prevent content changed during sending response. */
-				content = current->response.content;
+		/* prevent content changed during sending response. */
+		content = current->response.content;
 
-				/* qualify invalid or already ended stream to nullptr. */
-				if (content && (!content->is_valid() || content->is_end_of()))
-					content = nullptr;
+		/* qualify invalid or already ended stream to nullptr. */
+		if (content && (!content->is_valid() || content->is_end_of()))
+			content = nullptr;
 
-				if (content) {
-					/* try set non-block. */
-					content->set_nonblock(true);
-				}
+		if (content) {
+			/* try set non-block. */
+			content->set_nonblock(true);
+		}
 
-				/* set `Date` header which is requested time. */
-				if (!headers.get(http_header::DATE)) {
-					headers.set(http_header::DATE, http_date(timestamp).stringify());
-				}
+		/* set `Date` header which is requested time. */
+		if (!headers.get(http_header::DATE)) {
+			headers.set(http_header::DATE, http_date::cached(timestamp));
+		}
 
-				/* if `Server` header not set, set it as watermark from params. */
-				if (params.advertise.enable && !headers.get(http_header::SERVER)) {
-					headers.set(http_header::SERVER, params.advertise.watermark);
-				}
+		/* if `Server` header not set, set it as watermark from params. */
+		if (params.advertise.enable && !headers.get(http_header::SERVER)) {
+			headers.set(http_header::SERVER, params.advertise.watermark);
+		}
+
+		/* the connection is closed after responding to protocol errors. */
+		if (receives.has_error || !contexts.keep_alive) {
+			headers.set(http_header::CONNECTION, "close");
+		}
+
+		/* set `Content-Length` header or `Transfer-Encoding` header. */
+		if (content && (length = content->get_length()) < 0) {
+			/* requires chunked transfer. */
+			headers.set(http_header::TRANSFER_ENCODING, "chunked");
+			headers.unset(http_header::CONTENT_LENGTH);
+
+			sends.out_type = 1;
+		}
+
+		/* HEAD responses keep the length that the content would have. */
+		else if (!content && current->request.target.get_method() == http_method::HEAD &&
+			headers.get(http_header::CONTENT_LENGTH))
+		{
+			headers.unset(http_header::TRANSFER_ENCODING);
+			sends.out_type = 0;
+		}
+
+		else {
+			headers.set(http_header::CONTENT_LENGTH, std::to_string(length));
+			headers.unset(http_header::TRANSFER_ENCODING);
+
+			sends.out_type = 0;
+		}
+
+		/* encode response headers. (keeps its capacity across requests) */
+		head_buf.clear();
+		status.stringify(head_buf);
+		headers.stringify(head_buf);
+
+		/* content is read into line buffer, 1/2 size of buffer chunk. */
+		if (line_buf.size() < params.buffer_size_in_kb * 512)
+			line_buf.resize(params.buffer_size_in_kb * 512);
+	}
+
+	void http_default_driver::queue_slice(const void* data, size_t size) {
+		if (size) {
+			sends.slices[sends.slice_count].data = data;
+			sends.slices[sends.slice_count].size = size;
+			++sends.slice_count;
+		}
+	}
+
+	int32_t http_default_driver::flush_slices() {
+		while (sends.slice_index < sends.slice_count) {
+			io_slice_t* slices = sends.slices + sends.slice_index;
+			ssize_t sent = socket.writev(slices, size_t(sends.slice_count - sends.slice_index));
 
-				/* set `Content-Length` header or `Transfer-Encoding` header. */
-				if (content && (length = content->get_length()) < 0) {
-					/* requires chunked transfer. */
-					headers.set(http_header::TRANSFER_ENCODING, "chunked");
-					headers.unset(http_header::CONTENT_LENGTH);
+			if (sent <= 0) {
+				int32_t err = socket.get_errno();
 
-					sends.out_type = 1;
+				if (err == EINTR)
+					continue;
+
+				if (err == EAGAIN || err == EWOULDBLOCK) {
+					sends.congested = 1;
+					return EVENT_AGAIN;
 				}
 
-				else {
-					headers.set(http_header::CONTENT_LENGTH, std::to_string(length));
-					headers.unset(http_header::TRANSFER_ENCODING);
+				return EVENT_FAILURE;
+			}
 
-					sends.out_type = 0;
+			/* partially sent: advance slices without copying. */
+			while (sent > 0 && sends.slice_index < sends.slice_count) {
+				io_slice_t& slice = sends.slices[sends.slice_index];
+
+				if (size_t(sent) < slice.size) {
+					slice.data = (const char*)slice.data + sent;
+					slice.size -= size_t(sent);
+					break;
 				}
 
-				/* encode response headers. */
-				status.stringify(live_buf);
-				headers.stringify(live_buf);
+				sent -= ssize_t(slice.size);
+				++sends.slice_index;
+			}
+		}
 
-				/* copy to line buffer. */
-				if (line_buf.size() < live_buf.size())
-					line_buf.resize(live_buf.size());
+		sends.slice_index = sends.slice_count = 0;
+		return EVENT_SUCCESS;
+	}
 
-				/* resize line_buf to 1/2 size of buffer chunk. */
-				if (line_buf.size() < params.buffer_size_in_kb * 512)
-					line_buf.resize(params.buffer_size_in_kb * 512);
+	int32_t http_default_driver::send_file() {
+		while (sends.file_left > 0) {
+			size_t count = size_t(sends.file_left);
+			ssize_t sent = socket.sendfile(sends.file_fd, sends.file_off, count);
 
-				/* if chunk encoding, buffer should have blank at front of bytes. */
-				if (sends.out_type) {
-					size_t temp = line_buf.size(), chars = 1;
-					while (temp) { ++chars; temp >>= 4; }
+			if (sent <= 0) {
+				int32_t err = socket.get_errno();
+
+				if (sent < 0 && err == EINTR)
+					continue;
+
+				if (sent < 0 && (err == EAGAIN || err == EWOULDBLOCK))
+					return EVENT_AGAIN;
 
-					sends.buffer_bnk = int16_t(chars + 2); // for: hexhex...CRLF.
-					sends.buffer_pad = 2;		  // for: terminating CRLF.
+				/* not supported: fall back to read and copy if nothing sent yet. */
+				if (sent < 0 && (err == ENOTSUP || err == EINVAL || err == ENOSYS) &&
+					sends.file_left == content->get_length())
+				{
+					sends.file_state = NFILE_COPY;
+					return EVENT_RETRY;
 				}
 
-				memcpy(&line_buf[0], live_buf.c_str(), live_buf.size());
-				sends.buffer_len = live_buf.size();
-				});
+				/* the file is truncated or the link is lost. */
+				return EVENT_FAILURE;
+			}
+
+			sends.file_left -= sent;
+		}
+
+		content = nullptr;
+		return EVENT_SUCCESS;
+	}
+
+	void http_default_driver::read_ahead() {
+		size_t block = params.read_ahead_in_kb ? params.read_ahead_in_kb << 10 : line_buf.size();
+		std::shared_ptr<stream> content = this->content;
+		char* dest;
+
+		adapt_chunk();
+
+		/* blocks can be resized only before the first one is sent. */
+		if (chunk_size > block)
+			block = chunk_size;
+
+		if (!sends.block && ahead_buf.size() != block * 2)
+			ahead_buf.resize(block * 2);
+
+		if (block > ahead_buf.size() / 2)
+			block = ahead_buf.size() / 2;
+
+		dest = &ahead_buf[(ahead_buf.size() / 2) * size_t(sends.ahead_index)];
+		sends.reading = 1;
+
+		future_holder = asyncs->future_of([this, content, dest, block]() {
+			sends.ahead_len = content->read(dest, block);
+		});
+	}
+
+	void http_default_driver::adapt_chunk() {
+		size_t base = params.buffer_size_in_kb * 512;
+		size_t limit = params.send_chunk_max_in_kb << 10;
+
+		size_t target;
+		ssize_t space;
+
+		if (!sends.block_queued || limit <= base)
+			return;
+
+		sends.block_queued = 0;
+
+		/* stay at the maximum while the client takes bytes without blocking. */
+		if (!sends.congested && chunk_size >= limit)
+			return;
+
+		sends.congested = 0;
+
+		if ((space = socket.get_send_space()) < 0)
+			return;
+
+		/* follow free space of the send buffer: it runs out while the client is slow. */
+		target = size_t(space) < base ? base : (size_t(space) > limit ? limit : size_t(space));
+		chunk_size = target > chunk_size * 2 ? chunk_size * 2 : target;
+	}
+
+	void http_default_driver::uncork() {
+		if (sends.corked) {
+			sends.corked = 0;
+			socket.set_cork_enabled(false);
+		}
+	}
+
+	int32_t http_default_driver::wait_content() {
+		socket_watcher watcher = listener->watcher;
+		socket_t sock = socket;
+
+		/* the socket stays writable: its events would spin the loop while nothing to send. */
+		watcher.pause(sock);
+
+		if (content->notify_readable([watcher, sock]() mutable { watcher.pause(sock, false); }))
+			return EVENT_AGAIN;
+
+		watcher.pause(sock, false);
+		return content->can_read() ? EVENT_RETRY : EVENT_AGAIN;
+	}
+
+	int32_t http_default_driver::on_send() {
+		if (contexts.pipelining && !receives.has_error)
+			on_parse_ahead();
+
+		/* generates response header bytes. */
+		if (!sends.buffer_state) {
+			/* rejected requests have no content to look up: encode on the event loop. */
+			if (contexts.rejected)
+				encode_head();
+
+			else future_holder = asyncs->future_of([this]() { encode_head(); });
 
 			sends.buffer_state = 1;
 		}
 
-		/* wait asynchronous task completed. */
-		if (!future_holder.is_completed())
+		/* wait asynchronous task completed. (blocks read ahead are waited when they're needed) */
+		if (!sends.reading && !future_holder.is_completed())
 			return EVENT_AGAIN;
 
-		if (!sends.buffer_len) {
-			/* test content has reached on end of stream or not.*/
-			if (!content || content->is_end_of()) {
-				if (!sends.out_type || !sends.out_state) {
-					/* disconnect if protocol error occurred. */
-					if (receives.has_error)
-						return EVENT_FAILURE;
+		while (true) {
+			bool would_block = false;
 
-					return EVENT_SUCCESS;
-				}
+			/* send head, chunk-size, content and CRLF with single call. */
+			if (sends.slice_count) {
+				/* coalesce with bytes that follow immediately, instead of sending a partial frame. */
+				if (!sends.corked && (content || (sends.out_type && !sends.out_state)))
+					sends.corked = socket.set_cork_enabled(true);
 
-				/* if chunk terminator required, */
-				sends.out_state = 0;
+				int32_t ret = flush_slices();
 
-				/* write "0\r\n\r\n" to buffer. */
-				if (line_buf.size() < 5)
-					line_buf.resize(5);
+				if (ret != EVENT_SUCCESS)
+					return ret;
+			}
 
-				memcpy(&line_buf[0], "0\r\n\r\n", 5);
-				sends.buffer_len = 5;
-				return EVENT_RETRY;
+			/* bytes sent from the stream's own storage are consumed once flushed. */
+			if (sends.span_len) {
+				(content ? content : spanned)->consume(size_t(sends.span_len));
+				spanned = nullptr;
+				sends.span_len = 0;
 			}
 
-			if (!content->is_nonblock()) {
-				/* asynchronous reading. */
-				future_holder = asyncs->future_of([this]() {
-					char* front = &line_buf[0] + sends.buffer_bnk;
-					size_t safe_size = line_buf.size() - size_t(sends.buffer_bnk + sends.buffer_pad);
-					ssize_t read = content->read(front, safe_size);
-
-					if (read <= 0) {
-						/* may done. */
-						content = nullptr;
-						sends.out_state = 1;
-						return;
-					}
+			/* test content has reached on end of stream or not.*/
+			if (content && !sends.reading && content->is_end_of())
+				content = nullptr;
 
-					/* if chunk encoding, prepend hex length and append terminating CRLF. */
-					if (sends.out_type) {
-						safe_size = to_hex(sends.hex_buf, sizeof(sends.hex_buf) - sends.buffer_pad, read);
+			if (sends.head_state && !content && (!sends.out_type || sends.out_state)) {
+				/* disconnect if protocol error occurred. */
+				if (receives.has_error)
+					return EVENT_FAILURE;
 
-						sends.hex_buf[safe_size + 0] = '\r';
-						sends.hex_buf[safe_size + 1] = '\n';
-						safe_size += 2;
+				uncork();
+				return EVENT_SUCCESS;
+			}
 
-						memcpy(front - safe_size, sends.hex_buf, safe_size);
-						memmove(&line_buf[0], front - safe_size, read + safe_size);
-						front = &line_buf[0] + read + safe_size;
+			/* file-backed content is sent from the file without workers. */
+			if (content && sends.file_state == NFILE_UNTESTED) {
+				sends.file_state = NFILE_COPY;
 
-						*(front++) = '\r';
-						*(front++) = '\n';
+				if (!sends.out_type && content->get_file_span(sends.file_fd, sends.file_off, sends.file_left))
+					sends.file_state = NFILE_SENDFILE;
+			}
 
-						read += safe_size + 2;
-					}
+			if (content && sends.file_state == NFILE_SENDFILE) {
+				if (!sends.head_state) {
+					sends.head_state = 1;
+					queue_slice(head_buf.data(), head_buf.size());
+					continue;
+				}
 
-					sends.buffer_len = read;
-					});
+				int32_t ret = send_file();
 
-				return EVENT_AGAIN;
+				if (ret != EVENT_SUCCESS && ret != EVENT_RETRY)
+					return ret;
+
+				continue;
 			}
 
-			/* if non-blocking stream, read on event loop. */
-			char* front = &line_buf[0] + sends.buffer_bnk;
-			size_t safe_size = line_buf.size() - size_t(sends.buffer_bnk + sends.buffer_pad);
-			ssize_t read = content->read(front, safe_size);
+			/* bytes already in memory are sent without copying, blocking or not. */
+			size_t span_len = chunk_size;
+			const uint8_t* span = content && !sends.reading ? content->peek_span(span_len) : nullptr;
 
-			if (read <= 0) {
-				int32_t err = content->get_errno();
+			if (span) {
+				sends.block = (const char*)span;
+				sends.buffer_len = sends.span_len = int64_t(span_len);
 
-				if (err == EINTR)
-					return EVENT_RETRY;
+				/* size of the next span, by how the previous block was sent. */
+				adapt_chunk();
+
+				/* the rest of the stream: the response ends with these bytes, as read ones. */
+				ssize_t length = content->get_length(), offset = content->tell();
 
-				if (err == EWOULDBLOCK)
+				if (length >= 0 && offset >= 0 && offset + ssize_t(span_len) >= length)
+					spanned = std::move(content);
+			}
+
+			else if (content && !content->is_nonblock()) {
+				/* the first block: the head waits to be sent with its bytes. */
+				if (!sends.reading)
+					read_ahead();
+
+				if (!future_holder.is_completed()) {
+					uncork();
 					return EVENT_AGAIN;
+				}
+
+				sends.reading = 0;
 
-				else if (err)
+				if (sends.ahead_len < 0)
 					return EVENT_FAILURE;
 
-				content = nullptr;
-				sends.out_state = 1;
+				sends.block = &ahead_buf[(ahead_buf.size() / 2) * size_t(sends.ahead_index)];
+				sends.buffer_len = sends.ahead_len;
+				sends.ahead_index ^= 1;
+
+				/* read the next block into the other one while sending this. */
+				if (sends.ahead_len && !content->is_end_of())
+					read_ahead();
+
+				/* the chunk terminator goes with the last bytes. */
+				else content = nullptr;
 			}
 
-			/* if chunk encoding, prepend hex length and append terminating CRLF.*/
-			if (sends.out_type) {
-				safe_size = to_hex(sends.hex_buf, sizeof(sends.hex_buf) - sends.buffer_pad, read);
+			/* if non-blocking stream, read on event loop. */
+			else if (content) {
+				if (line_buf.size() < chunk_size)
+					line_buf.resize(chunk_size);
 
-				sends.hex_buf[safe_size + 0] = '\r';
-				sends.hex_buf[safe_size + 1] = '\n';
-				safe_size += 2;
+				ssize_t read = content->read(&line_buf[0], chunk_size);
 
-				memcpy(front - safe_size, sends.hex_buf, safe_size);
-				memmove(&line_buf[0], front - safe_size, read + safe_size);
-				front = &line_buf[0] + read + safe_size;
+				if (read <= 0) {
+					int32_t err = content->get_errno();
 
-				*(front++) = '\r';
-				*(front++) = '\n';
+					if (err == EINTR)
+						continue;
 
-				read += safe_size + sends.buffer_pad;
+					if (err == EWOULDBLOCK)
+						would_block = true;
+
+					else if (err)
+						return EVENT_FAILURE;
+
+					else content = nullptr;
+				}
+
+				else {
+					sends.block = &line_buf[0];
+					sends.buffer_len = read;
+
+					/* size of the next read, by how the previous block was sent. */
+					adapt_chunk();
+				}
+
+				/* the chunk terminator goes with the last bytes. */
+				if (content && content->is_end_of())
+					content = nullptr;
 			}
 
-			sends.buffer_len = read;
-		}
+			if (!sends.head_state) {
+				sends.head_state = 1;
+				queue_slice(head_buf.data(), head_buf.size());
+			}
 
-		if (sends.buffer_len) { /* if there are buffered bytes, flush them. */
-			ssize_t sent = socket.write(&line_buf[0] + sends.buffer_off, sends.buffer_len);
+			if (sends.buffer_len) {
+				sends.block_queued = 1;
 
-			if (sent <= 0) {
-				int32_t err = socket.get_errno();
+				/* if chunk encoding, hex length before and CRLF after the content. */
+				if (sends.out_type) {
+					size_t len = to_hex(sends.hex_buf, sizeof(sends.hex_buf) - 2, uint64_t(sends.buffer_len));
 
-				if (err == EINTR)
-					return EVENT_RETRY;
+					sends.hex_buf[len + 0] = '\r';
+					sends.hex_buf[len + 1] = '\n';
 
-				if (err == EAGAIN || err == EWOULDBLOCK) {
-					return EVENT_AGAIN;
+					queue_slice(sends.hex_buf, len + 2);
+					queue_slice(sends.block, size_t(sends.buffer_len));
+					queue_slice("\r\n", 2);
 				}
 
-				return EVENT_FAILURE;
+				else queue_slice(sends.block, size_t(sends.buffer_len));
+				sends.buffer_len = 0;
 			}
 
-			sends.buffer_off += sent;
-			sends.buffer_len -= sent;
+			/* if chunk terminator required, */
+			if (!content && sends.out_type && !sends.out_state) {
+				sends.out_state = 1;
+				queue_slice("0\r\n\r\n", 5);
+			}
 
-			if (!sends.buffer_len) {
-				sends.buffer_off = 0;
-				sends.buffer_len = 0;
+			if (!sends.slice_count && would_block) {
+				uncork();
+				return wait_content();
 			}
 		}
-
-		return EVENT_AGAIN;
 	}
 }
 }
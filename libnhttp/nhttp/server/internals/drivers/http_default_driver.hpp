@@ -1,6 +1,9 @@
 #pragma once
 #include "../../http_link.hpp"
 #include "../../http_params.hpp"
+#include "../../../protocol/http_request_parser.hpp"
+#include "../../../utils/small_vector.hpp"
+#include "../../../hal/coarse_clock_t.hpp"
 #include "../http_chunked_buffer.hpp"
 
 namespace nhttp {
@@ -36,63 +39,124 @@ namespace drivers {
 		EVENT_SUCCESS
 	};
 
+	/**
+	 * how file-backed content is sent.
+	 */
+	enum nhttp_file_state {
+		NFILE_UNTESTED = 0,
+		NFILE_SENDFILE,
+		NFILE_COPY			/* read and copy. */
+	};
+
 	class NHTTP_API http_default_driver : public http_link_driver {
 	private:
 		http_params params;
 		http_raw_listener* listener;
 		http_raw_link* raw_link;
 
-		/* future holder and line buffer. */
+		/* time of the request, and monotonic tick when the driver started waiting it. */
 		time_t timestamp;
+		int64_t tick;
+
+		/* future holder, response head and line buffer for content. */
 		future<void> future_holder;
+		std::string head_buf;
 		std::vector<char> line_buf;
 
+		/* two blocks to read blocking content ahead, while the other is being sent. */
+		std::vector<char> ahead_buf;
+
+		/* bytes to read and send content at once, adapted to the client. */
+		size_t chunk_size;
+
 		std::atomic<int8_t> state;
 		std::atomic<int8_t> context_state;
 		std::shared_ptr<http_raw_context> current;
 		std::shared_ptr<stream> content;
 
+		/* the stream whose last span is being sent, consumed once sent. */
+		std::shared_ptr<stream> spanned;
+
 		/* content handler. */
 		http_raw_content_handler* content_handler;
 
+		/* request line and headers parser. */
+		http_request_parser parser;
+
+		/* request parsed ahead while the current one is pending. */
+		struct pipelined_t {
+			std::shared_ptr<http_raw_context> context;
+			future<void> dispatch;
+
+			int8_t dispatched : 1;	/* 0: handled when it becomes current. (content, error or upgrade) */
+			int8_t has_error : 1;
+			int8_t keep_alive : 1;
+			int8_t pipelining : 1;
+		};
+
+		/* pipelined requests in order, the one being parsed ahead and a context to recycle. */
+		utils::small_vector<pipelined_t, 4> pipeline;
+		std::shared_ptr<http_raw_context> ahead, spare;
+
 	private:
 		struct {
 			int8_t has_done : 1;
-			int8_t has_target : 1;
 			int8_t has_error : 1; /* 0: no error, 1: unrecoverable error. */
 			int8_t read_more : 1;
-
-			ssize_t found_lf;
 		} receives;
 
 		struct {
 			int8_t keep_alive : 1;
 			int8_t has_raised : 1;
+			int8_t pipelining : 1; /* next requests can be parsed ahead. */
+			int8_t rejected : 1; /* answered without handlers. */
 		} contexts;
 
 		struct {
 			int8_t out_type : 1; /* 0: identity, 1: chunked. */
-			int8_t out_state : 1; /* 0: none, 1: terminating. */
+			int8_t out_state : 1; /* 0: none, 1: terminator queued. */
 			int8_t buffer_state : 1; /* 0: generating, 1: sending */
+			int8_t head_state : 1; /* 1: head queued. */
+			int8_t reading : 1; /* content is being read asynchronously. */
+			uint8_t file_state : 2; /* nhttp_file_state. */
+			int8_t corked : 1; /* partial frames are held until the response ends. */
+
+			int8_t block_queued : 1; /* a block of content is queued since the last adaption. */
+			int8_t congested : 1; /* the socket would block while sending the block. */
 
 			char hex_buf[18];
+			int64_t buffer_len; /* content bytes to send, in `block`. */
+			const char* block; /* line buffer, a block of read-ahead buffer or a span of the stream. */
+			int64_t span_len; /* bytes of the stream's span, consumed once sent. */
+
+			/* result of the block being read ahead, and index of it. */
+			int64_t ahead_len;
+			int8_t ahead_index;
+
+			/* slices to send: head, chunk-size, content, CRLF and terminator. */
+			io_slice_t slices[5];
+			int8_t slice_index, slice_count;
 
-			int16_t buffer_bnk;
-			int16_t buffer_pad; /* always 2 if chunked. */
-			int64_t buffer_off;
-			int64_t buffer_len;
+			/* file span of content sent by sendfile. */
+			int32_t file_fd;
+			int64_t file_off, file_left;
 		} sends;
 
 	private:
+		/* remember when the driver started waiting a request. */
+		inline void touch() {
+			timestamp = hal::coarse_clock_t::realtime();
+			tick = hal::coarse_clock_t::monotonic();
+		}
+
 		/* reset state structures. */
 		inline void reset_states() {
 			memset(&receives, 0, sizeof(receives));
 			memset(&contexts, 0, sizeof(contexts));
 			memset(&sends, 0, sizeof(sends));
 
-			/* find LF if buffer isn't empty. */
-			receives.found_lf = buffer->find('\n');
-			receives.read_more = receives.found_lf < 0;
+			/* parse pipelined bytes before reading more. */
+			receives.read_more = !buffer->get_size();
 			contexts.keep_alive = 1;
 		}
 
@@ -110,10 +174,57 @@ namespace drivers {
 	protected:
 		virtual bool on_event() override;
 
+	private:
+		/* close callbacks of the current context and contexts parsed ahead. */
+		static void on_closed(http_raw_context& context);
+		static void on_closed_ahead(http_raw_context& context);
+
+		/* determines nobody refers the context except the driver. */
+		static bool is_recyclable(const std::shared_ptr<http_raw_context>& context);
+
+		/* capacity of the ring that hands request content over. */
+		size_t get_feed_capacity(ssize_t length) const;
+
+		/* take the spare context if nobody refers it, or allocate new one. */
+		std::shared_ptr<http_raw_context> acquire_context();
+
+		/* keep the context to recycle it later. */
+		void retire_context(std::shared_ptr<http_raw_context>& context);
+
+		/* set addresses, hostname and queries of the context. */
+		void prepare_context(http_raw_context& context, const http_request_parser::framing_t& framing);
+
 	private:
 		int32_t on_receive();
+		int32_t on_parsed(int32_t ret);
 		int32_t on_handle();
+		int32_t on_promote();
+		void on_parse_ahead();
 		int32_t on_send();
+
+		/* encode status line and headers of the response into head buffer. */
+		void encode_head();
+
+		/* queue a slice to send, the bytes should live until flushed. */
+		void queue_slice(const void* data, size_t size);
+
+		/* send queued slices, continuing from partial writes. */
+		int32_t flush_slices();
+
+		/* send file-backed content from the file directly. */
+		int32_t send_file();
+
+		/* read the next block of blocking content on a worker. */
+		void read_ahead();
+
+		/* grow the chunk size while the send buffer has room, shrink if congested. */
+		void adapt_chunk();
+
+		/* push frames held by the socket, before waiting or at the end of the response. */
+		void uncork();
+
+		/* pause the link until non-blocking content has bytes, instead of polling it. */
+		int32_t wait_content();
 	};
 
 }
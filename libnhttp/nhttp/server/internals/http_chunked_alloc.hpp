@@ -1,6 +1,7 @@
 #pragma once
 #include "../../types.hpp"
 #include "../../hal/barrior_t.hpp"
+#include "../../hal/vmem_raw_t.hpp"
 
 namespace nhttp {
 namespace server {
@@ -21,18 +22,46 @@ namespace server {
 	class NHTTP_API http_chunked_alloc {
 	private:
 		hal::barrior_t barrior;
+		hal::vmem_raw_t region;
 		http_chunked_bytes* pool;
 
 		size_t max_chunks, chunk_size;
 		size_t active_chunks;
 
 	public:
-		http_chunked_alloc(size_t max_chunks, size_t chunk_size)
+		/**
+		 * @param preallocate reserve all chunks in one region up-front.
+		 * @param huge_pages try huge pages for the pre-allocated region.
+		 */
+		http_chunked_alloc(size_t max_chunks, size_t chunk_size, bool preallocate = false, bool huge_pages = true)
 			: pool(nullptr), max_chunks(max_chunks), chunk_size(chunk_size), active_chunks(0)
 		{
+			if (preallocate && max_chunks) {
+				/* keep each chunk header on its own cache line. */
+				size_t stride = (sizeof(http_chunked_bytes) + chunk_size + 63) & ~size_t(63);
+
+				/* if the region couldn't be reserved, fall back to lazy allocation. */
+				if (region.reserve(stride * max_chunks, huge_pages)) {
+					uint8_t* base = (uint8_t*)region.get_base();
+					region.prefault();
+
+					for (size_t i = max_chunks; i > 0; --i) {
+						auto* chunk = (http_chunked_bytes*)(base + stride * (i - 1));
+
+						chunk->next = pool;
+						pool = chunk;
+					}
+
+					active_chunks = max_chunks;
+				}
+			}
 		}
 
 		~http_chunked_alloc() {
+			/* pre-allocated chunks are released with their region. */
+			if (region.is_valid())
+				pool = nullptr;
+
 			while (pool) {
 				auto* cur = pool;
 				pool = pool->next;
@@ -41,6 +70,9 @@ namespace server {
 			}
 		}
 
+	public:
+		inline size_t get_chunk_size() const { return chunk_size; }
+
 	public:
 		/**
 		 * allocate a chunk.
@@ -1,5 +1,6 @@
 #pragma once
 #include "http_chunked_alloc.hpp"
+#include "../../hal/spinlock_t.hpp"
 
 namespace nhttp {
 namespace server {
@@ -12,6 +13,11 @@ namespace server {
 		std::atomic<size_t> total, length;
 
 	public:
+		http_chunked_buffer(const std::shared_ptr<http_chunked_alloc>& allocator)
+			: allocator(allocator), head(nullptr), tail(nullptr), total(0), length(0)
+		{
+		}
+
 		http_chunked_buffer(
 			const std::shared_ptr<http_chunked_alloc>& allocator, http_chunked_bytes* head)
 			: allocator(allocator), head(head), tail(head), total(head->size), length(0)
@@ -30,21 +36,71 @@ namespace server {
 		}
 
 	public:
-		inline size_t get_chunk_size() const { return head->size; }
+		inline size_t get_chunk_size() const { return allocator->get_chunk_size(); }
 
 		inline size_t get_capacity() const { return total; }
 		inline size_t get_size() const { return length; }
 
 		inline size_t get_left_capacity() const {
 			std::lock_guard<decltype(spinlock)> guard(spinlock);
+
+			if (!tail)
+				return 0;
+
 			return (tail->size - tail->right) +
 				   (tail->next ? tail->next->size : 0);
 		}
 
+		/* determines the buffer has no chunks or not. */
+		inline bool is_detached() const {
+			std::lock_guard<decltype(spinlock)> guard(spinlock);
+			return !head;
+		}
+
+		/* acquire a chunk if the buffer has been released. */
+		inline bool acquire() {
+			std::lock_guard<decltype(spinlock)> guard(spinlock);
+
+			if (head)
+				return true;
+
+			if (!(head = tail = allocator->alloc()))
+				return false;
+
+			total = head->size;
+			return true;
+		}
+
+		/* return all chunks back to allocator if the buffer is empty. */
+		inline bool release() {
+			std::lock_guard<decltype(spinlock)> guard(spinlock);
+
+			if (length)
+				return false;
+
+			while (head) {
+				auto* cur = head;
+				head = head->next;
+
+				allocator->dealloc(cur);
+			}
+
+			head = tail = nullptr;
+			total = 0;
+			return true;
+		}
+
 		/* try pre-allocate. */
 		inline bool preallocate() {
 			std::lock_guard<decltype(spinlock)> guard(spinlock);
 
+			if (!tail) {
+				if (!(head = tail = allocator->alloc()))
+					return false;
+
+				total = head->size;
+			}
+
 			if (tail->next)
 				return true;
 
@@ -78,11 +134,34 @@ namespace server {
 			return -1;
 		}
 
+		/**
+		 * get the first contiguous span of buffered bytes.
+		 * use `skip()` to consume bytes from the span.
+		 */
+		inline const uint8_t* peek_span(size_t& len) const {
+			std::lock_guard<decltype(spinlock)> guard(spinlock);
+			auto* cursor = head;
+
+			while (cursor && cursor->left == cursor->right)
+				cursor = cursor->next;
+
+			if (!cursor) {
+				len = 0;
+				return nullptr;
+			}
+
+			len = cursor->right - cursor->left;
+			return cursor->head + cursor->left;
+		}
+
 		/* skip bytes from buffer. */
 		inline size_t skip(size_t len) {
 			std::lock_guard<decltype(spinlock)> guard(spinlock);
 			size_t read_len = 0;
 
+			if (!head)
+				return 0;
+
 			while (len) {
 				size_t avail = head->right - head->left;
 
@@ -94,6 +173,10 @@ namespace server {
 						break;
 					}
 
+					/* pre-allocated chunk after the tail. */
+					if (tail == head)
+						tail = next;
+
 					total -= head->size;
 					allocator->dealloc(head);
 
@@ -103,7 +186,7 @@ namespace server {
 
 				avail = len > avail ? avail : len;
 				read_len += avail;
-				tail->left += avail;
+				head->left += avail;
 
 				len -= avail;
 				length -= avail;
@@ -118,26 +201,22 @@ namespace server {
 			std::lock_guard<decltype(spinlock)> guard(spinlock);
 			size_t read_len = 0;
 
-			auto head = this->head;
+			auto* cursor = this->head;
+			size_t offset = 0;
 
-			while (len) {
-				size_t avail = head->right - head->left;
+			while (cursor && len) {
+				size_t avail = cursor->right - cursor->left - offset;
 
 				if (!avail) {
-					auto* next = head->next;
-
-					if (!next) {
-						break;
-					}
-
-					total -= head->size;
-					head = next;
+					cursor = cursor->next;
+					offset = 0;
 					continue;
 				}
 
 				avail = len > avail ? avail : len;
-				memcpy(buf, tail->head + tail->left, avail);
+				memcpy(buf, cursor->head + cursor->left + offset, avail);
 
+				offset += avail;
 				read_len += avail;
 
 				buf = (uint8_t*)buf + avail;
@@ -152,6 +231,9 @@ namespace server {
 			std::lock_guard<decltype(spinlock)> guard(spinlock);
 			size_t read_len = 0;
 
+			if (!head)
+				return 0;
+
 			while (len) {
 				size_t avail = head->right - head->left;
 
@@ -163,6 +245,10 @@ namespace server {
 						break;
 					}
 
+					/* pre-allocated chunk after the tail. */
+					if (tail == head)
+						tail = next;
+
 					total -= head->size;
 					allocator->dealloc(head);
 
@@ -191,6 +277,14 @@ namespace server {
 			std::lock_guard<decltype(spinlock)> guard(spinlock);
 			size_t write_len = 0;
 
+			/* re-acquire a chunk if released. */
+			if (!tail) {
+				if (!(head = tail = allocator->alloc()))
+					return 0;
+
+				total = head->size;
+			}
+
 			while (len) {
 				size_t avail = tail->size - tail->right;
 
@@ -1,15 +1,53 @@
 #include "http_raw_link.hpp"
 #include "../http_raw_listener.hpp"
+#include "http_chunked_buffer.hpp"
 #include "drivers/http_default_driver.hpp"
 
 namespace nhttp {
 namespace server {
-	http_raw_link::http_raw_link(http_raw_listener* listener, std::shared_ptr<http_chunked_buffer> buffer)
-		: listener(listener), buffer(buffer)
+	/**
+	 * struct http_raw_link_block.
+	 * objects of a connection which share single allocation.
+	 * (ordered by access frequency on socket events)
+	 */
+	struct http_raw_link_block {
+		http_raw_link raw_link;
+		drivers::http_default_driver driver;
+		http_chunked_buffer buffer;
+		http_link link;
+
+		http_raw_link_block(http_raw_listener* listener, const std::shared_ptr<http_chunked_alloc>& allocator)
+			: raw_link(listener), driver(listener, &raw_link), buffer(allocator)
+		{
+		}
+	};
+
+	http_raw_link::http_raw_link(http_raw_listener* listener)
+		: listener(listener)
 	{
 		params = listener->get_params();
 	}
 
+	http_raw_link* http_raw_link::create(http_raw_listener* listener,
+		const std::shared_ptr<http_chunked_alloc>& allocator)
+	{
+		auto block = std::make_shared<http_raw_link_block>(listener, allocator);
+		http_raw_link* raw_link = &block->raw_link;
+
+		/* keep the block alive until the link destroyed. */
+		raw_link->buffer = std::shared_ptr<http_chunked_buffer>(block, &block->buffer);
+		raw_link->self = std::move(block);
+		return raw_link;
+	}
+
+	void http_raw_link::destroy(http_raw_link* link) {
+		std::shared_ptr<http_raw_link_block> block;
+
+		/* break the self reference outside of the link. */
+		link->buffer = nullptr;
+		std::swap(block, link->self);
+	}
+
 	void http_raw_link::on_initiate(const socket_t& socket,
 			const std::shared_ptr<asyncs::context>& asyncs)
 	{
@@ -25,11 +63,35 @@ namespace server {
 			params.tcp.keepalive.interval * 1000,
 			params.tcp.keepalive.max);
 
-		(link = std::make_shared<http_link>())
+		(link = std::shared_ptr<http_link>(self, &self->link))
 			->_is_alive.store(true);
 
+		/* capture addresses once: requests on this link read them from the link. */
+		ipv4_addr v4;
+		ipv6_addr v6;
+
+		if ((link->ipv6 = !sock.get_local_address(v4)) && sock.get_local_address(v6)) {
+			link->local_addr = hal::to_string(v6);
+			link->local_port = int32_t(v6.port);
+		}
+
+		else if (!link->ipv6) {
+			link->local_addr = hal::to_string(v4);
+			link->local_port = int32_t(v4.port);
+		}
+
+		else link->local_addr = "unknown";
+
+		if (!link->ipv6 && sock.get_remote_address(v4))
+			link->remote_addr = hal::to_string(v4);
+
+		else if (link->ipv6 && sock.get_remote_address(v6))
+			link->remote_addr = hal::to_string(v6);
+
+		else link->remote_addr = "unknown";
+
 		/* configure default protocol driver. */
-		driver = std::make_shared<drivers::http_default_driver>(listener, this);
+		driver = std::shared_ptr<http_link_driver>(self, &self->driver);
 		driver->raw_link = this;
 
 		/* initiate protocol driver.*/
@@ -11,7 +11,9 @@ namespace nhttp {
 
 namespace server {
 	class http_raw_listener;
+	class http_chunked_alloc;
 	class http_chunked_buffer;
+	struct http_raw_link_block;
 
 	/**
 	 * class http_raw_link.
@@ -21,19 +23,36 @@ namespace server {
 		friend class http_link_driver;
 
 	private:
-		http_params params;
-		http_raw_listener* listener;
+		/* hot: touched on every socket event. */
+		std::shared_ptr<http_link_driver> driver;
+		std::shared_ptr<http_link_driver> replace_to;
 		future<void> future_holder;
 
 		std::shared_ptr<http_link> link;
-		std::shared_ptr<http_link_driver> driver;
-		std::shared_ptr<http_link_driver> replace_to;
 		std::shared_ptr<http_chunked_buffer> buffer;
+		std::shared_ptr<http_raw_link_block> self;
+
+		http_raw_listener* listener;
+		http_params params;
 
 	public:
-		http_raw_link(http_raw_listener* listener, std::shared_ptr<http_chunked_buffer> buffer);
+		http_raw_link(http_raw_listener* listener);
 		~http_raw_link() { }
 
+	public:
+		/**
+		 * create a link with its default driver, logical link and buffer.
+		 * all of them are placed in single allocation.
+		 */
+		static http_raw_link* create(http_raw_listener* listener,
+			const std::shared_ptr<http_chunked_alloc>& allocator);
+
+		/**
+		 * destroy the link.
+		 * the allocation is freed when no context refers the logical link.
+		 */
+		static void destroy(http_raw_link* link);
+
 	protected:
 		/* initiate link. */
 		virtual void on_initiate(const socket_t& socket, const std::shared_ptr<asyncs::context>& asyncs) override;
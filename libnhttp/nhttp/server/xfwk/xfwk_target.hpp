@@ -126,45 +126,70 @@ namespace xfwk {
 	 */
 	class NHTTP_API xfwk_unified_target : public xfwk_target {
 	private:
-		std::map<http_method, xfwk_target_ptr> targets;
+		/* targets of well-known methods, indexed by method id. */
+		xfwk_target_ptr well_knowns[http_method::ALL_COUNT];
+		std::map<http_method, xfwk_target_ptr> extensions;
+		size_t count = 0;
 
 	public:
 		virtual ~xfwk_unified_target() { }
 
+	private:
+		static inline bool is_indexed(const http_method& method) {
+			return method.is_well_known() && size_t(method.get_id()) < http_method::ALL_COUNT;
+		}
+
+		/* find target for method without copying the pointer. */
+		inline const xfwk_target_ptr* find_target(const http_method& method) const {
+			if (is_indexed(method))
+				return well_knowns[method.get_id()] ? &well_knowns[method.get_id()] : nullptr;
+
+			auto i = extensions.find(method);
+			return i != extensions.end() ? &i->second : nullptr;
+		}
+
 	public:
 		/* determines this target is unified or not. */
 		virtual bool is_unifed() const { return true; }
 
 		/* determines a target implemented for method or not. */
 		inline bool has_target_for(const http_method& method) const {
-			return targets.find(method) != targets.end();
+			return find_target(method) != nullptr;
 		}
 
 		/* get target for method. */
 		inline xfwk_target_ptr get_target_for(const http_method& method) const {
-			auto i = targets.find(method);
-
-			if (i != targets.end())
-				return i->second;
-
-			return nullptr;
+			const xfwk_target_ptr* target = find_target(method);
+			return target ? *target : nullptr;
 		}
 
 		/* set target for method. */
 		inline this_ptr<xfwk_unified_target> set_target_for(const http_method& method, xfwk_target_ptr target) {
-			if (target)
-				targets.emplace(method, target);
+			if (!target)
+				unset_target_for(method);
+
+			else if (!is_indexed(method)) {
+				if (extensions.emplace(method, target).second)
+					++count;
+			}
+
+			else if (!well_knowns[method.get_id()]) {
+				well_knowns[method.get_id()] = target;
+				++count;
+			}
 
-			else unset_target_for(method);
 			return this;
 		}
 
 		/* unset target for method. */
 		inline this_ptr<xfwk_unified_target> unset_target_for(const http_method& method) {
-			auto i = targets.find(method);
+			if (!is_indexed(method))
+				count -= extensions.erase(method);
 
-			if (i != targets.end())
-				targets.erase(method);
+			else if (well_knowns[method.get_id()]) {
+				well_knowns[method.get_id()] = nullptr;
+				--count;
+			}
 
 			return this;
 		}
@@ -172,13 +197,13 @@ namespace xfwk {
 	public:
 		/* call individual method for handling the request. */
 		virtual http_response_ptr handle(http_request_ptr request) const {
-			auto i = targets.find(request->get_target().get_method());
+			const xfwk_target_ptr* target = find_target(request->get_target().get_method());
 
-			if (i != targets.end() && i->second) {
-				return i->second->handle(request);
+			if (target) {
+				return (*target)->handle(request);
 			}
 
-			if (targets.size()) /* if other methods implemented, */
+			if (count) /* if other methods implemented, */
 				return make_response(405);
 
 			/* otherwise, returns no response. */
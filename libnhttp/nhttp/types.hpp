@@ -6,6 +6,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <stdlib.h>
+#include <string.h>
 
 #if !(defined(_WIN64) || defined(_WIN32))
 #include <unistd.h>
@@ -22,6 +23,7 @@
 #include <list>
 #include <atomic>
 #include <mutex>
+#include <functional>
 #include <regex>
 
 #ifdef _MSC_VER
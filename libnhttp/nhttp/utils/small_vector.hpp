@@ -0,0 +1,181 @@
+#pragma once
+#include "../types.hpp"
+#include <type_traits>
+#include <utility>
+#include <new>
+
+namespace nhttp {
+namespace utils {
+
+	/**
+	 * class small_vector<type, inlines>.
+	 * vector which stores first `inlines` elements without heap allocation.
+	 */
+	template<typename _type, size_t _inlines>
+	class small_vector {
+	public:
+		using type = _type;
+		using value_type = _type;
+		using iterator = type*;
+		using const_iterator = const type*;
+
+		static_assert(_inlines > 0, "small_vector<type, 0> is meaningless, use std::vector instead.");
+
+	private:
+		type* ptr;
+		size_t count, cap;
+		alignas(type) uint8_t blobs[sizeof(type) * _inlines];
+
+		inline type* inlines() { return (type*)blobs; }
+		inline bool is_inline() const { return ptr == (const type*)blobs; }
+
+	public:
+		small_vector() : ptr((type*)blobs), count(0), cap(_inlines) { }
+		small_vector(const small_vector& other) : ptr((type*)blobs), count(0), cap(_inlines) {
+			reserve(other.count);
+
+			for (const type& each : other)
+				new (ptr + count++) type(each);
+		}
+
+		small_vector(small_vector&& other) : ptr((type*)blobs), count(0), cap(_inlines) {
+			take(std::move(other));
+		}
+
+		~small_vector() {
+			clear();
+
+			if (!is_inline())
+				::operator delete(ptr);
+		}
+
+		inline small_vector& operator =(const small_vector& other) {
+			if (this != &other) {
+				clear();
+				reserve(other.count);
+
+				for (const type& each : other)
+					new (ptr + count++) type(each);
+			}
+
+			return *this;
+		}
+
+		inline small_vector& operator =(small_vector&& other) {
+			if (this != &other) {
+				clear();
+				take(std::move(other));
+			}
+
+			return *this;
+		}
+
+	public:
+		inline size_t size() const { return count; }
+		inline size_t capacity() const { return cap; }
+		inline bool empty() const { return !count; }
+
+		inline type* data() { return ptr; }
+		inline const type* data() const { return ptr; }
+
+		inline iterator begin() { return ptr; }
+		inline iterator end() { return ptr + count; }
+		inline const_iterator begin() const { return ptr; }
+		inline const_iterator end() const { return ptr + count; }
+		inline const_iterator cbegin() const { return ptr; }
+		inline const_iterator cend() const { return ptr + count; }
+
+		inline type& operator[](size_t i) { return ptr[i]; }
+		inline const type& operator[](size_t i) const { return ptr[i]; }
+
+		inline type& front() { return ptr[0]; }
+		inline type& back() { return ptr[count - 1]; }
+		inline const type& front() const { return ptr[0]; }
+		inline const type& back() const { return ptr[count - 1]; }
+
+	public:
+		/* reserve spaces for `n` elements. */
+		inline void reserve(size_t n) {
+			if (n <= cap)
+				return;
+
+			type* new_ptr = (type*) ::operator new(sizeof(type) * n);
+
+			for (size_t i = 0; i < count; ++i) {
+				new (new_ptr + i) type(std::move(ptr[i]));
+				ptr[i].~type();
+			}
+
+			if (!is_inline())
+				::operator delete(ptr);
+
+			ptr = new_ptr;
+			cap = n;
+		}
+
+		template<typename ... arg_types>
+		inline type& emplace_back(arg_types&& ... args) {
+			if (count >= cap)
+				reserve(cap << 1);
+
+			return *(new (ptr + count++) type(std::forward<arg_types>(args)...));
+		}
+
+		inline void push_back(const type& value) { emplace_back(value); }
+		inline void push_back(type&& value) { emplace_back(std::move(value)); }
+
+		inline void pop_back() {
+			if (count)
+				ptr[--count].~type();
+		}
+
+		/* erase an element and shift elements after it. */
+		inline iterator erase(const_iterator at) {
+			size_t i = size_t(at - ptr);
+
+			if (i >= count)
+				return end();
+
+			for (size_t j = i + 1; j < count; ++j)
+				ptr[j - 1] = std::move(ptr[j]);
+
+			ptr[--count].~type();
+			return ptr + i;
+		}
+
+		/* destroy all elements. (capacity is kept) */
+		inline void clear() {
+			for (size_t i = 0; i < count; ++i)
+				ptr[i].~type();
+
+			count = 0;
+		}
+
+	private:
+		/* take elements from other, stealing its heap storage if any. */
+		inline void take(small_vector&& other) {
+			if (!other.is_inline()) {
+				if (!is_inline())
+					::operator delete(ptr);
+
+				ptr = other.ptr;
+				count = other.count;
+				cap = other.cap;
+
+				other.ptr = other.inlines();
+				other.count = 0;
+				other.cap = _inlines;
+				return;
+			}
+
+			reserve(other.count);
+
+			for (type& each : other)
+				new (ptr + count++) type(std::move(each));
+
+			other.clear();
+		}
+	};
+
+}
+}
\ No newline at end of file
@@ -39,65 +39,58 @@ namespace nhttp {
 		return retval;
 	}
 
-	/* decode url string. */
-	inline std::string urldecode(const std::string& str) {
-		const char* src_end = str.c_str() + str.size();
-		const char* src = str.c_str();
-		std::string retval;
+	/* determines the string has escaped characters or not. */
+	inline bool needs_urldecode(const char* str, size_t len) {
+		return memchr(str, '%', len) || memchr(str, '+', len);
+	}
+
+	/**
+	 * decode url string in place.
+	 * @returns length of decoded string.
+	 */
+	inline size_t urldecode_inplace(char* str, size_t len) {
+		const char* src = str;
+		const char* src_end = str + len;
+		char* dst = str;
 
 		while (src < src_end) {
-			const char* p = (const char*)memchr(src, '%', size_t(src_end - src));
+			char c = *src++;
+
+			/* replace '+' to ' '. */
+			if (c == '+')
+				*dst++ = ' ';
 
-			/* append front strings. */
-			if (!p) {
-				/* replace '+' to ' '. */
-				while (src < src_end) {
-					p = (const char*)memchr(src, '+', size_t(src_end - src));
+			else if (c != '%')
+				*dst++ = c;
 
-					if (!p) {
-						retval.append(src);
-						break;
-					}
+			else {
+				/* if incompleted, waste lefts.*/
+				if (src_end - src < 2)
+					break;
 
-					retval.append(src, size_t(p - src));
-					retval.push_back(' ');
-					src = p + 1;
-				}
+				char _1 = ::tolower(*(src++));
+				char _2 = ::tolower(*(src++));
+				char _r = 0;
 
-				break;
-			}
-			else if (size_t(p - src) > 0) {
-				/* replace '+' to ' '. */
-				while (src < p) {
-					auto k = (const char*)memchr(src, '+', size_t(p - src));
-
-					if (!k) {
-						retval.append(src, size_t(p - src));
-						break;
-					}
-
-					retval.append(src, size_t(k - src));
-					retval.push_back(' ');
-					src = k + 1;
-				}
-			}
+				if (_1 >= '0' && _1 <= '9')      _r |= char((_1 - '0' +  0) << 4);
+				else if (_1 >= 'a' && _1 <= 'f') _r |= char((_1 - 'a' + 10) << 4);
 
-			/* if incompleted, waste lefts.*/
-			if (p + 2 == src_end) break;
+				if (_2 >= '0' && _2 <= '9')      _r |= char((_2 - '0' +  0) << 0);
+				else if (_2 >= 'a' && _2 <= 'f') _r |= char((_2 - 'a' + 10) << 0);
 
-			char _1 = ::tolower(*(++p));
-			char _2 = ::tolower(*(++p));
-			char _r = 0;
+				*dst++ = _r;
+			}
+		}
 
-			if (_1 >= '0' && _1 <= '9')      _r |= char((_1 - '0' +  0) << 4);
-			else if (_1 >= 'a' && _1 <= 'f') _r |= char((_1 - 'a' + 10) << 4);
+		return size_t(dst - str);
+	}
 
-			if (_2 >= '0' && _2 <= '9')      _r |= char((_2 - '0' +  0) << 0);
-			else if (_2 >= 'a' && _2 <= 'f') _r |= char((_2 - 'a' + 10) << 0);
+	/* decode url string. */
+	inline std::string urldecode(const std::string& str) {
+		std::string retval(str);
 
-			retval.push_back(_r);
-			src = p + 1;
-		}
+		if (needs_urldecode(retval.c_str(), retval.size()))
+			retval.resize(urldecode_inplace(&retval[0], retval.size()));
 
 		return retval;
 	}